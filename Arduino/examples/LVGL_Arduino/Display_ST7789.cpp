@@ -1,12 +1,6 @@
 #include "Display_ST7789.h"
-   
-#define SPI_WRITE(_dat)         SPI.transfer(_dat)
-#define SPI_WRITE_Word(_dat)    SPI.transfer16(_dat)
-
-// ============================================================================
-// Global Instance (for C-style API compatibility layer)
-// ============================================================================
-static ST7789Display* g_display_instance = nullptr;
+#include <esp_heap_caps.h>
+#include "Pixel_Ops.h"
 
 // ============================================================================
 // ST7789Display Class Implementation
@@ -28,7 +22,17 @@ ST7789Display::ST7789Display()
       _spi_freq(SPIFreq),
       _backlight_freq(Frequency),
       _backlight_resolution(Resolution),
-      _initialized(false)
+      _initialized(false),
+      _cmd_ready_us(0),
+      _init_time_us(0),
+      _spi(nullptr),
+      _fill_buf(nullptr),
+      _async(false),
+      _job_queue(nullptr),
+      _done_sem(nullptr),
+      _transfer_task(nullptr),
+      _pending(0),
+      _done_cb(nullptr)
 {
 }
 
@@ -48,7 +52,17 @@ ST7789Display::ST7789Display(const ST7789Config& config)
       _spi_freq(config.spi_freq),
       _backlight_freq(config.backlight_freq),
       _backlight_resolution(config.backlight_resolution),
-      _initialized(false)
+      _initialized(false),
+      _cmd_ready_us(0),
+      _init_time_us(0),
+      _spi(nullptr),
+      _fill_buf(nullptr),
+      _async(false),
+      _job_queue(nullptr),
+      _done_sem(nullptr),
+      _transfer_task(nullptr),
+      _pending(0),
+      _done_cb(nullptr)
 {
 }
 
@@ -56,168 +70,381 @@ ST7789Display::ST7789Display(const ST7789Config& config)
  * Destructor
  */
 ST7789Display::~ST7789Display() {
-    // Clean up resources (if needed)
+    if (_async) {
+        waitForTransfers();
+        vTaskDelete(_transfer_task);
+        vQueueDelete(_job_queue);
+        vSemaphoreDelete(_done_sem);
+    }
+    if (_spi != nullptr) {
+        spi_bus_remove_device(_spi);
+    }
+    heap_caps_free(_fill_buf);
 }
 
 /**
- * Initialize SPI bus
+ * Initialize SPI bus and add the panel as a DMA device
+ * The SD card joins the same bus later, see SDCardManager::begin()
  */
-void ST7789Display::spiInit() {
-    SPI.begin(EXAMPLE_PIN_NUM_SCLK, EXAMPLE_PIN_NUM_MISO, EXAMPLE_PIN_NUM_MOSI);
+bool ST7789Display::spiInit() {
+    spi_bus_config_t buscfg = {};
+    buscfg.mosi_io_num = EXAMPLE_PIN_NUM_MOSI;
+    buscfg.miso_io_num = EXAMPLE_PIN_NUM_MISO;
+    buscfg.sclk_io_num = EXAMPLE_PIN_NUM_SCLK;
+    buscfg.quadwp_io_num = -1;
+    buscfg.quadhd_io_num = -1;
+    buscfg.max_transfer_sz = ST7789_SPI_MAX_TRANSFER;
+
+    esp_err_t ret = spi_bus_initialize(ST7789_SPI_HOST, &buscfg, SPI_DMA_CH_AUTO);
+    if (ret != ESP_OK) {
+        printf("ERROR: SPI bus init failed (%d)\r\n", ret);
+        return false;
+    }
+
+    // CS and DC stay under software control, the device only clocks data
+    spi_device_interface_config_t devcfg = {};
+    devcfg.mode = 0;
+    devcfg.clock_speed_hz = _spi_freq;
+    devcfg.spics_io_num = -1;
+    devcfg.flags = SPI_DEVICE_HALFDUPLEX;
+    devcfg.queue_size = ST7789_TRANSFER_QUEUE_DEPTH;
+
+    ret = spi_bus_add_device(ST7789_SPI_HOST, &devcfg, &_spi);
+    if (ret != ESP_OK) {
+        printf("ERROR: SPI device add failed (%d)\r\n", ret);
+        spi_bus_free(ST7789_SPI_HOST);
+        return false;
+    }
+
+    _fill_buf = (uint16_t*)heap_caps_malloc(ST7789_FILL_CHUNK_PIXELS * sizeof(uint16_t),
+                                            MALLOC_CAP_DMA);
+    if (_fill_buf == nullptr) {
+        printf("ERROR: Failed to allocate fill buffer\r\n");
+        spi_bus_remove_device(_spi);
+        spi_bus_free(ST7789_SPI_HOST);
+        _spi = nullptr;
+        return false;
+    }
+    return true;
 }
 
 /**
- * Write command to LCD
+ * Start a write transaction (CS held low until endWrite)
+ * The bus stays acquired, so SD card transfers wait until endWrite
  */
-void ST7789Display::writeCommand(uint8_t cmd) {
-    SPI.beginTransaction(SPISettings(_spi_freq, MSBFIRST, SPI_MODE0));
+void ST7789Display::beginWrite() {
+    spi_device_acquire_bus(_spi, portMAX_DELAY);
     digitalWrite(_pin_cs, LOW);
-    digitalWrite(_pin_dc, LOW);
-    SPI_WRITE(cmd);
+    _stats.transactions++;
+}
+
+/**
+ * Finish a write transaction
+ */
+void ST7789Display::endWrite() {
     digitalWrite(_pin_cs, HIGH);
-    SPI.endTransaction();
+    spi_device_release_bus(_spi);
+}
+
+/**
+ * Send command byte inside an open transaction
+ * DC is toggled in-line and left high for the following parameters
+ */
+void ST7789Display::sendCommand(uint8_t cmd) {
+    spi_transaction_t trans = {};
+    trans.flags = SPI_TRANS_USE_TXDATA;
+    trans.length = 8;
+    trans.tx_data[0] = cmd;
+
+    digitalWrite(_pin_dc, LOW);
+    spi_device_polling_transmit(_spi, &trans);
+    digitalWrite(_pin_dc, HIGH);
+    _stats.commands++;
+    _stats.bytes++;
+}
+
+/**
+ * Send data block inside an open transaction
+ * Busy-waits on each transfer, which is cheaper than sleeping for
+ * parameter blocks; blocking pixel pushes keep the CPU for their length.
+ */
+void ST7789Display::sendData(const uint8_t* data, uint32_t len) {
+    if (len > 0 && len <= 4) {
+        // Parameter blocks go out from the transaction itself, no DMA buffer
+        spi_transaction_t trans = {};
+        trans.flags = SPI_TRANS_USE_TXDATA;
+        trans.length = len * 8;
+        memcpy(trans.tx_data, data, len);
+        spi_device_polling_transmit(_spi, &trans);
+        _stats.bytes += len;
+        return;
+    }
+    while (len > 0) {
+        uint32_t chunk = len < ST7789_SPI_MAX_TRANSFER ? len : ST7789_SPI_MAX_TRANSFER;
+        spi_transaction_t trans = {};
+        trans.length = chunk * 8;
+        trans.tx_buffer = data;
+        spi_device_polling_transmit(_spi, &trans);
+        _stats.bytes += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * Send data block inside an open transaction (transfer task context)
+ * Chunks are queued back to back and the task sleeps while the DMA runs
+ */
+void ST7789Display::sendDataQueued(const uint8_t* data, uint32_t len) {
+    spi_transaction_t trans[ST7789_TRANSFER_QUEUE_DEPTH] = {};
+    spi_transaction_t* done = nullptr;
+    uint32_t queued = 0;
+
+    for (uint32_t i = 0; len > 0; i++) {
+        if (queued == ST7789_TRANSFER_QUEUE_DEPTH) {
+            spi_device_get_trans_result(_spi, &done, portMAX_DELAY);
+            queued--;
+        }
+        uint32_t chunk = len < ST7789_SPI_MAX_TRANSFER ? len : ST7789_SPI_MAX_TRANSFER;
+        spi_transaction_t& t = trans[i % ST7789_TRANSFER_QUEUE_DEPTH];
+        t.length = chunk * 8;
+        t.tx_buffer = data;
+        if (spi_device_queue_trans(_spi, &t, portMAX_DELAY) != ESP_OK) {
+            break;
+        }
+        queued++;
+        _stats.bytes += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    while (queued > 0) {
+        spi_device_get_trans_result(_spi, &done, portMAX_DELAY);
+        queued--;
+    }
+}
+
+/**
+ * Send window setup inside an open transaction
+ *
+ * The last programmed window is cached: CASET/RASET are only sent when
+ * they change, and when the new area starts on the row right after the
+ * previous full-area write with the same column span, RAMWRC (memory
+ * write continue) is sent instead of a new window. RASET is programmed
+ * open-ended (to the last panel row) so that consecutive rows can keep
+ * continuing.
+ * @param track true if exactly the full area is written afterwards
+ */
+void ST7789Display::sendWindow(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, bool track) {
+    uint16_t col_start, col_end, row_start, row_end, row_max;
+    if (_horizontal) {
+        // Horizontal mode
+        col_start = x1 + _offset_x;
+        col_end = x2 + _offset_x;
+        row_start = y1 + _offset_y;
+        row_end = y2 + _offset_y;
+        row_max = _height - 1 + _offset_y;
+    } else {
+        // Vertical mode
+        col_start = y1 + _offset_y;
+        col_end = y2 + _offset_y;
+        row_start = x1 + _offset_x;
+        row_end = x2 + _offset_x;
+        row_max = _width - 1 + _offset_x;
+    }
+
+    _window_stats.windows++;
+    bool same_cols = _window.valid &&
+                     col_start == _window.col_start && col_end == _window.col_end;
+
+    if (same_cols && _window.cursor_valid &&
+        row_start == _window.next_row && row_end <= _window.row_end) {
+        // Contiguous with the previous write: just continue RAM write
+        sendCommand(0x3C);
+        _window_stats.continued++;
+        _window_stats.bytes_saved += 2 * ST7789_WINDOW_CMD_BYTES;
+    } else {
+        if (same_cols) {
+            _window_stats.caset_skipped++;
+            _window_stats.bytes_saved += ST7789_WINDOW_CMD_BYTES;
+        } else {
+            uint8_t caset[4] = {
+                (uint8_t)(col_start >> 8), (uint8_t)col_start,
+                (uint8_t)(col_end >> 8), (uint8_t)col_end
+            };
+            sendCommand(0x2A);
+            sendData(caset, sizeof(caset));
+            _window.col_start = col_start;
+            _window.col_end = col_end;
+        }
+
+        if (_window.valid && row_start == _window.row_start && row_max == _window.row_end) {
+            _window_stats.raset_skipped++;
+            _window_stats.bytes_saved += ST7789_WINDOW_CMD_BYTES;
+        } else {
+            uint8_t raset[4] = {
+                (uint8_t)(row_start >> 8), (uint8_t)row_start,
+                (uint8_t)(row_max >> 8), (uint8_t)row_max
+            };
+            sendCommand(0x2B);
+            sendData(raset, sizeof(raset));
+            _window.row_start = row_start;
+            _window.row_end = row_max;
+        }
+
+        sendCommand(0x2C);
+        _window.valid = true;
+    }
+
+    // Address counter ends at the start of the next row only after a full-area write
+    _window.cursor_valid = track;
+    _window.next_row = row_end + 1;
+}
+
+/**
+ * Send a repeating pixel pattern inside an open transaction
+ * The pattern is expanded into the DMA fill block, a whole number of
+ * repeats long, and the block is sent until the area is covered, so no
+ * full-size source buffer is needed.
+ * @param queued true in the transfer task (sleep on the DMA)
+ */
+void ST7789Display::sendPattern(const uint16_t* pattern, uint8_t pattern_len, uint32_t pixels, bool queued) {
+    uint32_t block_len = ST7789_FILL_CHUNK_PIXELS / pattern_len * pattern_len;
+    if (block_len > pixels) {
+        block_len = (pixels + pattern_len - 1) / pattern_len * pattern_len;
+    }
+    if (pattern_len == 1) {
+        pixel_fill565(_fill_buf, pattern[0], block_len);
+    } else {
+        for (uint32_t i = 0; i < block_len; i++) {
+            _fill_buf[i] = pattern[i % pattern_len];
+        }
+    }
+
+    while (pixels > 0) {
+        uint32_t len = pixels < block_len ? pixels : block_len;
+        if (queued) {
+            sendDataQueued((const uint8_t*)_fill_buf, len * sizeof(uint16_t));
+        } else {
+            sendData((const uint8_t*)_fill_buf, len * sizeof(uint16_t));
+        }
+        pixels -= len;
+    }
+}
+
+/**
+ * Write command with parameter block in a single transaction
+ */
+void ST7789Display::writeCommandData(uint8_t cmd, const uint8_t* data, uint32_t len) {
+    _window.cursor_valid = false;
+    beginWrite();
+    sendCommand(cmd);
+    if (len > 0) {
+        sendData(data, len);
+    }
+    endWrite();
+}
+
+/**
+ * Write command to LCD
+ */
+void ST7789Display::writeCommand(uint8_t cmd) {
+    writeCommandData(cmd, nullptr, 0);
 }
 
 /**
  * Write 8-bit data to LCD
  */
 void ST7789Display::writeData(uint8_t data) {
-    SPI.beginTransaction(SPISettings(_spi_freq, MSBFIRST, SPI_MODE0));
-    digitalWrite(_pin_cs, LOW);
-    digitalWrite(_pin_dc, HIGH);
-    SPI_WRITE(data);
-    digitalWrite(_pin_cs, HIGH);
-    SPI.endTransaction();
+    beginWrite();
+    sendData(&data, 1);
+    endWrite();
 }
 
 /**
  * Write 16-bit data to LCD
  */
 void ST7789Display::writeData16(uint16_t data) {
-    SPI.beginTransaction(SPISettings(_spi_freq, MSBFIRST, SPI_MODE0));
-    digitalWrite(_pin_cs, LOW);
-    digitalWrite(_pin_dc, HIGH);
-    SPI_WRITE_Word(data);
-    digitalWrite(_pin_cs, HIGH);
-    SPI.endTransaction();
+    uint8_t bytes[2] = { (uint8_t)(data >> 8), (uint8_t)data };
+    beginWrite();
+    sendData(bytes, sizeof(bytes));
+    endWrite();
 }
 
 /**
  * Write data bytes to LCD
  */
 void ST7789Display::writeDataBytes(uint8_t* data, uint32_t len) {
-    SPI.beginTransaction(SPISettings(_spi_freq, MSBFIRST, SPI_MODE0));
-    digitalWrite(_pin_cs, LOW);
-    digitalWrite(_pin_dc, HIGH);
-    SPI.transferBytes(data, nullptr, len);
-    digitalWrite(_pin_cs, HIGH);
-    SPI.endTransaction();
+    beginWrite();
+    sendData(data, len);
+    endWrite();
+}
+
+/**
+ * Wait out the remainder of a reset/sleep-out delay
+ * The delay runs from when it was started, so work done in between
+ * (backlight, SPI setup) overlaps with it instead of adding to it.
+ */
+void ST7789Display::waitReady() {
+    int32_t wait_us;
+    while ((wait_us = (int32_t)(_cmd_ready_us - micros())) > 0) {
+        if (wait_us >= 1000) {
+            delay(wait_us / 1000);
+        } else {
+            delayMicroseconds(wait_us);
+        }
+    }
 }
 
 /**
  * Hardware reset
+ * Returns right after releasing RST, waitReady() covers the recovery time
  */
 void ST7789Display::hardwareReset() {
-    digitalWrite(_pin_cs, LOW);
-    delay(50);
+    invalidateWindow();
+    digitalWrite(_pin_cs, HIGH);
     digitalWrite(_pin_rst, LOW);
-    delay(50);
+    delayMicroseconds(ST7789_RESET_PULSE_MS * 1000);
     digitalWrite(_pin_rst, HIGH);
-    delay(50);
+    _cmd_ready_us = micros() + ST7789_RESET_RECOVERY_MS * 1000;
 }
 
 /**
  * Initialize registers
+ * The shared init table is sent as one burst, split only where a
+ * command needs a delay before the next one
  */
 void ST7789Display::initRegisters() {
-    //************* Start Initial Sequence **********// 
-    writeCommand(0x11);
-    delay(120);
-    writeCommand(0x36);
-    if (_horizontal)
-        writeData(0x00);
-    else
-        writeData(0x70);
-
-    writeCommand(0x3A);
-    writeData(0x05);
-
-    writeCommand(0xB0);
-    writeData(0x00);
-    writeData(0xE8);
-    
-    writeCommand(0xB2);
-    writeData(0x0C);
-    writeData(0x0C);
-    writeData(0x00);
-    writeData(0x33);
-    writeData(0x33);
-
-    writeCommand(0xB7);
-    writeData(0x35);
-
-    writeCommand(0xBB);
-    writeData(0x35);
-
-    writeCommand(0xC0);
-    writeData(0x2C);
-
-    writeCommand(0xC2);
-    writeData(0x01);
-
-    writeCommand(0xC3);
-    writeData(0x13);
-
-    writeCommand(0xC4);
-    writeData(0x20);
-
-    writeCommand(0xC6);
-    writeData(0x0F);
-
-    writeCommand(0xD0);
-    writeData(0xA4);
-    writeData(0xA1);
-
-    writeCommand(0xD6);
-    writeData(0xA1);
-
-    writeCommand(0xE0);
-    writeData(0xF0);
-    writeData(0x00);
-    writeData(0x04);
-    writeData(0x04);
-    writeData(0x04);
-    writeData(0x05);
-    writeData(0x29);
-    writeData(0x33);
-    writeData(0x3E);
-    writeData(0x38);
-    writeData(0x12);
-    writeData(0x12);
-    writeData(0x28);
-    writeData(0x30);
-
-    writeCommand(0xE1);
-    writeData(0xF0);
-    writeData(0x07);
-    writeData(0x0A);
-    writeData(0x0D);
-    writeData(0x0B);
-    writeData(0x07);
-    writeData(0x28);
-    writeData(0x33);
-    writeData(0x3E);
-    writeData(0x36);
-    writeData(0x14);
-    writeData(0x14);
-    writeData(0x29);
-    writeData(0x32);
-
-    writeCommand(0x21);
-
-    writeCommand(0x11);
-    delay(120);
-    writeCommand(0x29); 
+    waitReady();
+    beginWrite();
+    for (size_t i = 0; i < ST7789_INIT_TABLE_SIZE; i++) {
+        const st7789_init_cmd_t& init_cmd = st7789_init_table[i];
+        uint8_t len = init_cmd.data_bytes & ST7789_INIT_LEN_MASK;
+
+        sendCommand(init_cmd.cmd);
+        if (len > 0) {
+            sendData(init_cmd.data, len);
+        }
+        if (init_cmd.data_bytes & ST7789_INIT_DELAY) {
+            endWrite();
+            _cmd_ready_us = micros() + init_cmd.delay_ms * 1000;
+            waitReady();
+            beginWrite();
+        }
+    }
+
+    // Orientation and pixel format (16 bit/pixel), then display on.
+    // LCMCTRL XBGR|XMX|XMH is XORed with MADCTL: BGR order, X mirrored
+    uint8_t lcmctrl = 0x2C;
+    uint8_t madctl = _horizontal ? 0x00 : 0x70;
+    uint8_t colmod = 0x05;
+    sendCommand(0xC0);
+    sendData(&lcmctrl, 1);
+    sendCommand(0x36);
+    sendData(&madctl, 1);
+    sendCommand(0x3A);
+    sendData(&colmod, 1);
+    sendCommand(0x29);
+    endWrite();
 }
 
 /**
@@ -234,105 +461,260 @@ void ST7789Display::backlightInit() {
  * Fully initialize the LCD
  */
 bool ST7789Display::begin() {
+    uint32_t start = micros();
+
     // Configure GPIO pins
     pinMode(_pin_cs, OUTPUT);
     pinMode(_pin_dc, OUTPUT);
     pinMode(_pin_rst, OUTPUT);
     
+    // Hardware reset first, the rest of the setup runs during its recovery time
+    hardwareReset();
+    
     // Initialize backlight
     backlightInit();
     
     // Initialize SPI
-    spiInit();
-    
-    // Hardware reset
-    hardwareReset();
+    if (!spiInit()) {
+        return false;
+    }
     
     // Initialize registers
     initRegisters();
     
+    _init_time_us = micros() - start;
     _initialized = true;
     return true;
 }
 
 /**
  * Set drawing window
+ * CASET, RASET and RAMWR are sent in one transaction
  */
 void ST7789Display::setWindow(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
-    if (_horizontal) {
-        // Horizontal mode
-        // Set X coordinate
-        writeCommand(0x2A);
-        writeData(x1 >> 8);
-        writeData(x1 + _offset_x);
-        writeData(x2 >> 8);
-        writeData(x2 + _offset_x);
-        
-        // Set Y coordinate
-        writeCommand(0x2B);
-        writeData(y1 >> 8);
-        writeData(y1 + _offset_y);
-        writeData(y2 >> 8);
-        writeData(y2 + _offset_y);
-    } else {
-        // Vertical mode
-        // Set X coordinate
-        writeCommand(0x2A);
-        writeData(y1 >> 8);
-        writeData(y1 + _offset_y);
-        writeData(y2 >> 8);
-        writeData(y2 + _offset_y);
-        
-        // Set Y coordinate
-        writeCommand(0x2B);
-        writeData(x1 >> 8);
-        writeData(x1 + _offset_x);
-        writeData(x2 >> 8);
-        writeData(x2 + _offset_x);
-    }
-    writeCommand(0x2C);
+    waitForTransfers();
+    beginWrite();
+    sendWindow(x1, y1, x2, y2, false);
+    endWrite();
 }
 
 /**
- * 绘制像素缓冲区
+ * Draw pixel buffer
+ * Window setup and pixel data share one transaction
  */
 void ST7789Display::drawPixelBuffer(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t* buffer) {
     uint16_t width = x2 - x1 + 1;
     uint16_t height = y2 - y1 + 1;
     uint32_t numBytes = width * height * sizeof(uint16_t);
     
-    setWindow(x1, y1, x2, y2);
-    writeDataBytes((uint8_t*)buffer, numBytes);
+    waitForTransfers();
+    beginWrite();
+    sendWindow(x1, y1, x2, y2, true);
+    sendData((const uint8_t*)buffer, numBytes);
+    endWrite();
 }
 
 /**
- * 清屏
+ * Enable asynchronous pixel transfers
+ *
+ * Blocking pushes busy-wait on spi_device_polling_transmit(), so the CPU
+ * is tied up for the whole transfer. In async mode the transfer task
+ * queues the pixel data instead and sleeps until the DMA completes,
+ * leaving the CPU free for rendering.
  */
-void ST7789Display::clearScreen(uint16_t color) {
-    // 创建一行的缓冲区
-    uint16_t lineBuffer[_width];
-    for (uint16_t i = 0; i < _width; i++) {
-        lineBuffer[i] = color;
+bool ST7789Display::beginAsync(UBaseType_t task_priority) {
+    if (!_initialized) {
+        printf("ERROR: beginAsync() requires begin() first\r\n");
+        return false;
     }
-    
-    setWindow(0, 0, _width - 1, _height - 1);
-    
-    // 逐行填充
-    for (uint16_t y = 0; y < _height; y++) {
-        writeDataBytes((uint8_t*)lineBuffer, _width * sizeof(uint16_t));
+    if (_async) {
+        return true;
+    }
+
+    _job_queue = xQueueCreate(ST7789_TRANSFER_QUEUE_DEPTH, sizeof(TransferJob));
+    _done_sem = xSemaphoreCreateBinary();
+    if (_job_queue == nullptr || _done_sem == nullptr ||
+        xTaskCreate(transferTask, "lcd_xfer", ST7789_TRANSFER_TASK_STACK,
+                    this, task_priority, &_transfer_task) != pdPASS) {
+        printf("ERROR: Failed to start transfer task\r\n");
+        if (_job_queue != nullptr) vQueueDelete(_job_queue);
+        if (_done_sem != nullptr) vSemaphoreDelete(_done_sem);
+        _job_queue = nullptr;
+        _done_sem = nullptr;
+        return false;
+    }
+
+    _async = true;
+    return true;
+}
+
+/**
+ * Queue pixel buffer for asynchronous transfer
+ */
+bool ST7789Display::drawPixelBufferAsync(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+                                         const uint16_t* buffer, void* user_ctx) {
+    if (!_async) {
+        drawPixelBuffer(x1, y1, x2, y2, (uint16_t*)buffer);
+        if (_done_cb != nullptr) {
+            _done_cb(user_ctx);
+        }
+        return true;
+    }
+
+    TransferJob job = { x1, y1, x2, y2, buffer, 0, user_ctx };
+    return queueJob(job);
+}
+
+/**
+ * Hand a job to the transfer task
+ */
+bool ST7789Display::queueJob(const TransferJob& job) {
+    _pending++;
+    if (xQueueSend(_job_queue, &job, portMAX_DELAY) != pdTRUE) {
+        _pending--;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Wait for all queued transfers
+ */
+void ST7789Display::waitForTransfers() {
+    while (_async && _pending > 0) {
+        xSemaphoreTake(_done_sem, pdMS_TO_TICKS(10));
+    }
+}
+
+/**
+ * Execute one queued transfer (transfer task context)
+ * The bus is held for the whole job, the SD card waits until it is done
+ */
+void ST7789Display::runTransfer(const TransferJob& job) {
+    beginWrite();
+    sendWindow(job.x1, job.y1, job.x2, job.y2, true);
+    if (job.buffer != nullptr) {
+        uint32_t numBytes = (uint32_t)(job.x2 - job.x1 + 1) * (job.y2 - job.y1 + 1) * sizeof(uint16_t);
+        sendDataQueued((const uint8_t*)job.buffer, numBytes);
+    } else {
+        uint32_t pixels = (uint32_t)(job.x2 - job.x1 + 1) * (job.y2 - job.y1 + 1);
+        sendPattern(&job.fill_color, 1, pixels, true);
+    }
+    endWrite();
+}
+
+/**
+ * Transfer task: drains the job queue and signals completion
+ */
+void ST7789Display::transferTask(void* arg) {
+    ST7789Display* self = (ST7789Display*)arg;
+    TransferJob job;
+
+    for (;;) {
+        if (xQueueReceive(self->_job_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        self->runTransfer(job);
+        if (self->_done_cb != nullptr) {
+            self->_done_cb(job.user_ctx);
+        }
+        self->_pending--;
+        xSemaphoreGive(self->_done_sem);
+    }
+}
+
+/**
+ * Fill rectangle with a single color
+ */
+void ST7789Display::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    fillPattern(x, y, w, h, &color, 1);
+}
+
+/**
+ * Queue a single color fill for asynchronous transfer
+ */
+bool ST7789Display::fillRectAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                                  uint16_t color, void* user_ctx) {
+    if (!_async) {
+        fillRect(x, y, w, h, color);
+        if (_done_cb != nullptr) {
+            _done_cb(user_ctx);
+        }
+        return true;
+    }
+    if (w == 0 || h == 0) {
+        return false;
     }
+
+    TransferJob job = { x, y, (uint16_t)(x + w - 1), (uint16_t)(y + h - 1), nullptr, color, user_ctx };
+    return queueJob(job);
 }
 
 /**
- * 设置背光亮度
- * @param brightness 亮度百分比 0-100
+ * Fill rectangle with a repeating pixel pattern
+ */
+bool ST7789Display::fillPattern(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                                const uint16_t* pattern, uint8_t pattern_len) {
+    if (pattern_len == 0 || pattern_len * sizeof(uint16_t) > ST7789_PATTERN_MAX_BYTES) {
+        printf("ERROR: Fill pattern must be 1-%d pixels\r\n", ST7789_PATTERN_MAX_BYTES / 2);
+        return false;
+    }
+    if (w == 0 || h == 0) {
+        return true;
+    }
+
+    waitForTransfers();
+    beginWrite();
+    sendWindow(x, y, x + w - 1, y + h - 1, true);
+    sendPattern(pattern, pattern_len, (uint32_t)w * h, false);
+    endWrite();
+    return true;
+}
+
+/**
+ * Clear screen
+ */
+void ST7789Display::clearScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+}
+
+/**
+ * Define the vertical scroll area
+ * Queued pixel pushes are drained first so they land with the old layout
+ */
+bool ST7789Display::setScrollArea(uint16_t top_fixed, uint16_t scroll_lines, uint16_t bottom_fixed) {
+    if ((uint32_t)top_fixed + scroll_lines + bottom_fixed != ST7789_RAM_ROWS) {
+        return false;
+    }
+
+    const uint8_t params[6] = {
+        (uint8_t)(top_fixed >> 8), (uint8_t)top_fixed,
+        (uint8_t)(scroll_lines >> 8), (uint8_t)scroll_lines,
+        (uint8_t)(bottom_fixed >> 8), (uint8_t)bottom_fixed,
+    };
+    waitForTransfers();
+    writeCommandData(0x33, params, sizeof(params));
+    return true;
+}
+
+/**
+ * Set the vertical scroll start address
+ */
+void ST7789Display::setScrollStart(uint16_t line) {
+    const uint8_t params[2] = { (uint8_t)(line >> 8), (uint8_t)line };
+    waitForTransfers();
+    writeCommandData(0x37, params, sizeof(params));
+}
+
+/**
+ * Set backlight brightness
+ * @param brightness Brightness percentage 0-100
  */
 void ST7789Display::setBacklight(uint8_t brightness) {
     if (brightness > 100) brightness = 100;
     
-    // 使用简单公式：brightness * 10
-    // 将百分比 0-100 映射到 PWM值 0-1000（10位PWM最大值1024）
-    // 与原始代码完全一致
+    // Use simple formula: brightness * 10
+    // Map percentage 0-100 to PWM value 0-1000 (10-bit PWM max 1024)
     uint32_t duty = brightness * 10;
     ledcWrite(_pin_backlight, duty);
-}
\ No newline at end of file
+}
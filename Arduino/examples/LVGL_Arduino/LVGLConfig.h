@@ -0,0 +1,86 @@
+#pragma once
+#include <Arduino.h>
+
+// ============================================================================
+// Default Values
+// ============================================================================
+#define LVGL_DEFAULT_BUF_LINES       16      // 1/20 of a 172x320 screen
+#define LVGL_BUF_LINES_FULL_FRAME    0       // buf_lines value for a full-frame buffer
+
+// Refresh mode: 1 = redraw the whole screen on every change, 0 = redraw only the changed areas
+#define LVGL_FULL_REFRESH            0
+// Areas at least this wide (percent of the screen) are widened to full rows
+#define LVGL_FULL_ROW_PERCENT        75
+// Two areas are merged if the merged rectangle costs at most this many extra pixels
+#define LVGL_MERGE_SLACK_PX          512
+// Print the flush rate (bytes/s) every second while the screen changes (0 = disabled)
+#define LVGL_FLUSH_RATE_LOG          0
+// Flush mode: 1 = asynchronous DMA (render overlaps the transfer), 0 = blocking
+#define LVGL_FLUSH_ASYNC             1
+// Areas of at least this many pixels are checked for a single color and sent as a fill (0 = disabled)
+#define LVGL_FILL_MIN_PIXELS         256
+// Print average/max frame time every N refreshes (0 = disabled)
+#define LVGL_FRAME_STATS_INTERVAL    300
+// Longest sleep of loop() between LVGL runs in ms (loop() also polls the wireless scan)
+#define LVGL_LOOP_MAX_SLEEP_MS       100
+
+/**
+ * LVGL draw buffer allocation strategy
+ * Mirrors lvgl_buffer_alloc_t of the ESP-IDF driver
+ */
+enum class LVGLBufferAlloc : uint8_t {
+    Internal,   // Internal RAM
+    SPIRAM,     // External PSRAM (if available; not DMA-capable for the LCD)
+    DMA         // DMA-capable internal RAM (required for asynchronous flush)
+};
+
+/**
+ * LVGL driver configuration structure
+ * Used for parameter configuration of the object-oriented interface,
+ * mirrors lvgl_config_t of the ESP-IDF driver
+ *
+ * Buffer strategies:
+ *  - Single:     buf_lines = N, use_double_buffer = false
+ *  - Double:     buf_lines = N, use_double_buffer = true
+ *  - Full frame: buf_lines = LVGL_BUF_LINES_FULL_FRAME (one or two full screens)
+ */
+struct LVGLConfig {
+    // Display resolution (0 = take it from the display)
+    uint16_t hor_res;
+    uint16_t ver_res;
+
+    // Buffer configuration
+    uint16_t buf_lines;             // Buffer size in lines, LVGL_BUF_LINES_FULL_FRAME for a whole screen
+    bool use_double_buffer;         // Render into one buffer while the other is flushed
+    LVGLBufferAlloc buf_alloc;      // Buffer allocation strategy
+
+    // Refresh settings
+    bool full_refresh;              // Always redraw entire screen
+    bool async_flush;               // Flush with DMA (needs DMA-capable buffers)
+    uint8_t full_row_percent;       // Widen areas at least this wide (%) to full rows
+    uint16_t merge_slack_px;        // Extra pixels allowed when merging two areas
+    uint16_t fill_min_pixels;       // Solid-area fill threshold (0 = disabled)
+
+    // Statistics
+    uint16_t frame_stats_interval;  // Print frame statistics every N refreshes (0 = disabled)
+
+    /**
+     * Get default configuration
+     * Based on the standard configuration of the current hardware
+     */
+    static LVGLConfig getDefault() {
+        LVGLConfig cfg;
+        cfg.hor_res = 0;
+        cfg.ver_res = 0;
+        cfg.buf_lines = LVGL_DEFAULT_BUF_LINES;
+        cfg.use_double_buffer = true;
+        cfg.buf_alloc = LVGLBufferAlloc::DMA;
+        cfg.full_refresh = LVGL_FULL_REFRESH;
+        cfg.async_flush = LVGL_FLUSH_ASYNC;
+        cfg.full_row_percent = LVGL_FULL_ROW_PERCENT;
+        cfg.merge_slack_px = LVGL_MERGE_SLACK_PX;
+        cfg.fill_min_pixels = LVGL_FILL_MIN_PIXELS;
+        cfg.frame_stats_interval = LVGL_FRAME_STATS_INTERVAL;
+        return cfg;
+    }
+};
@@ -38,7 +38,7 @@ void setup()
     printf("ERROR: Display initialization failed!\n");
     return;
   }
-  printf("✓ Display initialized: %dx%d\n", display.width(), display.height());
+  printf("✓ Display initialized: %dx%d in %u us\n", display.width(), display.height(), (unsigned)display.getInitTimeUs());
   // Set backlight brightness
   display.setBacklight(60);  // 60% brightness (using percentage directly here)
   
@@ -98,6 +98,5 @@ void loop()
     Scan_finish = true;
   }
   
-  Timer_Loop();
-  delay(5);
+  delay(Timer_Loop());   // Sleeps until LVGL's next timer instead of waking every 5 ms
 }
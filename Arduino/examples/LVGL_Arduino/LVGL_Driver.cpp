@@ -5,17 +5,350 @@
     The provided LVGL library file must be installed first
 ******************************************************************************/
 #include "LVGL_Driver.h"
+#include <esp_memory_utils.h>
+#include <inttypes.h>
+#include "Pixel_Ops.h"
 
 // Reference to the display object in the main program
 extern ST7789Display display;
 
-static lv_disp_draw_buf_t draw_buf;
-static lv_color_t buf1[ LVGL_BUF_LEN ];
-static lv_color_t buf2[ LVGL_BUF_LEN ];
-// static lv_color_t* buf1 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN, MALLOC_CAP_SPIRAM);
-// static lv_color_t* buf2 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN, MALLOC_CAP_SPIRAM);
-    
+// ============================================================================
+// Global Instance (for C-style API compatibility layer)
+// ============================================================================
+static LVGLDriver* g_lvgl_instance = nullptr;
 
+// ============================================================================
+// LVGLDriver Class Implementation
+// ============================================================================
+
+/**
+ * Default constructor - uses default configuration
+ */
+LVGLDriver::LVGLDriver(ST7789Display& display)
+    : LVGLDriver(display, LVGLConfig::getDefault())
+{
+}
+
+/**
+ * Configuration constructor - uses custom configuration
+ */
+LVGLDriver::LVGLDriver(ST7789Display& display, const LVGLConfig& config)
+    : _display(display),
+      _config(config),
+      _initialized(false),
+      _async_flush(false),
+      _disp(nullptr),
+      _buf1(nullptr),
+      _buf2(nullptr),
+      _buf_size(0),
+      _last_tick(0),
+      _frame_count(0),
+      _frame_time_sum(0),
+      _frame_time_max(0),
+      _flush_bytes(0),
+      _flush_rate(0),
+      _flush_rate_start(0)
+{
+}
+
+/**
+ * Destructor
+ */
+LVGLDriver::~LVGLDriver() {
+    if (_disp != nullptr) {
+        _display.waitForTransfers();
+        lv_disp_remove(_disp);
+    }
+    freeBuffers();
+}
+
+/**
+ * Allocate draw buffers
+ * Falls back to a single buffer, then to fewer lines, when memory is short
+ */
+bool LVGLDriver::allocBuffers() {
+    uint32_t caps;
+    switch (_config.buf_alloc) {
+        case LVGLBufferAlloc::SPIRAM:
+            caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+            break;
+        case LVGLBufferAlloc::DMA:
+            caps = MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL;
+            break;
+        default:
+            caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+            break;
+    }
+
+    uint16_t lines = _config.buf_lines;
+    if (lines == LVGL_BUF_LINES_FULL_FRAME || lines > _config.ver_res) {
+        lines = _config.ver_res;
+    }
+
+    for (; lines > 0; lines /= 2) {
+        size_t bytes = (size_t)_config.hor_res * lines * sizeof(lv_color_t);
+        _buf1 = (lv_color_t*)heap_caps_malloc(bytes, caps);
+        if (_buf1 == nullptr) {
+            continue;
+        }
+        if (_config.use_double_buffer) {
+            _buf2 = (lv_color_t*)heap_caps_malloc(bytes, caps);
+            if (_buf2 == nullptr) {
+                printf("LVGL: no memory for second buffer, using a single buffer\r\n");
+            }
+        }
+        _buf_size = (uint32_t)_config.hor_res * lines;
+        if (lines < _config.buf_lines) {
+            printf("LVGL: buffer reduced to %u lines\r\n", (unsigned)lines);
+        }
+        return true;
+    }
+
+    printf("ERROR: Failed to allocate LVGL draw buffer\r\n");
+    return false;
+}
+
+/**
+ * Free draw buffers
+ */
+void LVGLDriver::freeBuffers() {
+    heap_caps_free(_buf1);
+    heap_caps_free(_buf2);
+    _buf1 = nullptr;
+    _buf2 = nullptr;
+    _buf_size = 0;
+}
+
+/**
+ * Initialize LVGL driver
+ */
+bool LVGLDriver::begin() {
+    if (_initialized) {
+        return true;
+    }
+    if (!_display.isInitialized()) {
+        printf("ERROR: LVGLDriver::begin() requires display.begin() first\r\n");
+        return false;
+    }
+
+    if (_config.hor_res == 0) _config.hor_res = _display.width();
+    if (_config.ver_res == 0) _config.ver_res = _display.height();
+
+    if (!allocBuffers()) {
+        return false;
+    }
+
+    // DMA reads the buffers in place, spi_master would copy any other buffer on every flush
+    if (_config.async_flush) {
+        if (!esp_ptr_dma_capable(_buf1) || (_buf2 != nullptr && !esp_ptr_dma_capable(_buf2))) {
+            printf("LVGL: buffers are not DMA-capable, using blocking transfers\r\n");
+        } else {
+            _display.onTransferDone(transferDoneCallback);
+            _async_flush = _display.beginAsync();
+            if (!_async_flush) {
+                printf("LVGL: async flush unavailable, using blocking transfers\r\n");
+            }
+        }
+    }
+
+    lv_init();
+    lv_disp_draw_buf_init(&_draw_buf, _buf1, _buf2, _buf_size);
+
+    /*Initialize the display*/
+    lv_disp_drv_init(&_disp_drv);
+    _disp_drv.hor_res = _config.hor_res;
+    _disp_drv.ver_res = _config.ver_res;
+    _disp_drv.flush_cb = flushCallback;
+    _disp_drv.full_refresh = _config.full_refresh;    /**< 1: Always make the whole screen redrawn*/
+    if (!_config.full_refresh) {
+        _disp_drv.rounder_cb = rounderCallback;
+        _disp_drv.render_start_cb = renderStartCallback;
+    }
+    _disp_drv.draw_buf = &_draw_buf;
+    if (_async_flush) {
+        _disp_drv.wait_cb = waitCallback;
+    }
+    if (_config.frame_stats_interval > 0) {
+        _disp_drv.monitor_cb = monitorCallback;
+    }
+    _disp_drv.user_data = this;
+    _disp = lv_disp_drv_register(&_disp_drv);
+
+    printf("LVGL: %s buffer, %u lines (%u bytes each), %s flush\r\n",
+           _buf2 != nullptr ? "double" : "single",
+           (unsigned)(_buf_size / _config.hor_res), (unsigned)(_buf_size * sizeof(lv_color_t)),
+           _async_flush ? "async" : "blocking");
+
+    _last_tick = millis();
+    _flush_rate_start = _last_tick;
+    _initialized = true;
+    return true;
+}
+
+/**
+ * Run LVGL timers and update the flush rate
+ */
+uint32_t LVGLDriver::loop() {
+    advanceTick();
+    uint32_t sleep_ms = lv_timer_handler(); /* let the GUI do its work */
+
+    uint32_t now = millis();
+    if (now - _flush_rate_start >= 1000) {
+        _flush_rate = (uint64_t)_flush_bytes * 1000 / (now - _flush_rate_start);
+#if LVGL_FLUSH_RATE_LOG
+        if (_flush_rate > 0) {
+            printf("LVGL flush: %" PRIu32 " bytes/s\r\n", _flush_rate);
+        }
+#endif
+        _flush_bytes = 0;
+        _flush_rate_start = now;
+    }
+    return sleep_ms;
+}
+
+/**
+ * Timekeeping without a tick timer
+ * The elapsed millis() are handed to LVGL whenever it is about to look at
+ * the time: before lv_timer_handler() and, within a refresh, at each flush
+ * and flush wait so the refresh time reported to monitor_cb stays correct.
+ * This replaces a periodic 5 ms esp_timer; loop() still wakes whenever
+ * Timer_Loop() says the next LVGL timer is due.
+ */
+void LVGLDriver::advanceTick() {
+    uint32_t now = millis();
+    if (now != _last_tick) {
+        lv_tick_inc(now - _last_tick);
+        _last_tick = now;
+    }
+}
+
+/**
+ * Display flushing
+ * In async mode the transfer is queued and lv_disp_flush_ready() is
+ * called from the transfer-done callback, so LVGL renders into the
+ * other buffer while this one is on the wire.
+ * Solid-color areas (backgrounds) are sent as a fill instead; the fill
+ * does not read the draw buffer, so it is handed back at once.
+ */
+void LVGLDriver::flush(const lv_area_t* area, lv_color_t* color_p) {
+    advanceTick();
+    uint32_t size = lv_area_get_size(area);
+    _flush_bytes += size * sizeof(lv_color_t);
+
+    if (_config.fill_min_pixels > 0 && size >= _config.fill_min_pixels &&
+        pixel_is_solid565((const uint16_t*)&color_p->full, size)) {
+        _display.fillRectAsync(area->x1, area->y1, lv_area_get_width(area), lv_area_get_height(area),
+                               color_p->full, nullptr);
+        lv_disp_flush_ready(&_disp_drv);
+        return;
+    }
+
+    if (_async_flush) {
+        _display.drawPixelBufferAsync(area->x1, area->y1, area->x2, area->y2,
+                                      (const uint16_t*)&color_p->full, &_disp_drv);
+        return;
+    }
+
+    _display.drawPixelBuffer(area->x1, area->y1, area->x2, area->y2, (uint16_t*)&color_p->full);
+    lv_disp_flush_ready(&_disp_drv);
+}
+
+/**
+ * LVGL flush callback
+ */
+void LVGLDriver::flushCallback(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* color_p) {
+    ((LVGLDriver*)disp_drv->user_data)->flush(area, color_p);
+}
+
+/**
+ * Called by LVGL while it waits for a flush; blocks instead of spinning
+ */
+void LVGLDriver::waitCallback(lv_disp_drv_t* disp_drv) {
+    LVGLDriver* self = (LVGLDriver*)disp_drv->user_data;
+    self->_display.waitForTransfers();
+    self->advanceTick();
+}
+
+/**
+ * Frame-time statistics: time = render + flush of one refresh period
+ */
+void LVGLDriver::monitorCallback(lv_disp_drv_t* disp_drv, uint32_t time, uint32_t px) {
+    LVGLDriver* self = (LVGLDriver*)disp_drv->user_data;
+
+    self->_frame_count++;
+    self->_frame_time_sum += time;
+    if (time > self->_frame_time_max) self->_frame_time_max = time;
+
+    if (self->_frame_count >= self->_config.frame_stats_interval) {
+        printf("LVGL frame time (%s): avg %" PRIu32 " ms, max %" PRIu32 " ms over %" PRIu32 " frames, %" PRIu32 " bytes/s\r\n",
+               self->_async_flush ? "async" : "sync",
+               self->_frame_time_sum / self->_frame_count, self->_frame_time_max,
+               self->_frame_count, self->_flush_rate);
+        self->_frame_count = 0;
+        self->_frame_time_sum = 0;
+        self->_frame_time_max = 0;
+    }
+}
+
+/**
+ * Area rounding
+ * The panel has no alignment requirement, but a new column range costs a
+ * CASET. Wide areas are widened to full rows so that consecutive areas
+ * share the column window and continue the RAM write (see
+ * ST7789Display::sendWindow).
+ */
+void LVGLDriver::rounderCallback(lv_disp_drv_t* disp_drv, lv_area_t* area) {
+    LVGLDriver* self = (LVGLDriver*)disp_drv->user_data;
+    if (lv_area_get_width(area) * 100 >= disp_drv->hor_res * self->_config.full_row_percent) {
+        area->x1 = 0;
+        area->x2 = disp_drv->hor_res - 1;
+    }
+}
+
+/**
+ * Area merging
+ * LVGL only joins overlapping areas. Nearby areas (e.g. two labels on the
+ * same line) are merged here when the bounding box adds few pixels,
+ * trading some extra pixels for one window setup less.
+ * The merged area is kept at the higher index: LVGL has already picked
+ * the last unjoined area to flag the end of the frame.
+ */
+void LVGLDriver::renderStartCallback(lv_disp_drv_t* disp_drv) {
+    LVGLDriver* self = (LVGLDriver*)disp_drv->user_data;
+    lv_disp_t* disp = _lv_refr_get_disp_refreshing();
+    if (disp == nullptr || disp_drv->full_refresh) return;
+
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+        if (disp->inv_area_joined[i]) continue;
+        for (uint16_t j = i + 1; j < disp->inv_p; j++) {
+            if (disp->inv_area_joined[j]) continue;
+
+            lv_area_t joined;
+            _lv_area_join(&joined, &disp->inv_areas[i], &disp->inv_areas[j]);
+            if (lv_area_get_size(&joined) <= lv_area_get_size(&disp->inv_areas[i]) +
+                                              lv_area_get_size(&disp->inv_areas[j]) +
+                                              self->_config.merge_slack_px) {
+                lv_area_copy(&disp->inv_areas[j], &joined);
+                disp->inv_area_joined[i] = 1;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * DMA transfer finished: hand the buffer back to LVGL
+ */
+void LVGLDriver::transferDoneCallback(void* user_ctx) {
+    // Fills are queued without a context, their buffer was released already
+    if (user_ctx != nullptr) {
+        lv_disp_flush_ready((lv_disp_drv_t*)user_ctx);
+    }
+}
+
+// ============================================================================
+// C-style API Implementation (compatibility layer)
+// ============================================================================
 
 /* Serial debugging */
 void Lvgl_print(const char * buf)
@@ -23,44 +356,29 @@ void Lvgl_print(const char * buf)
     // Serial.printf(buf);
     // Serial.flush();
 }
-
-/*  Display flushing 
-    Displays LVGL content on the LCD
-    This function implements associating LVGL data to the LCD screen
-    
-    Now using object-oriented API: display.drawPixelBuffer()
-*/
-void Lvgl_Display_LCD( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
-{
-  // Using the new object-oriented API
-  display.drawPixelBuffer(area->x1, area->y1, area->x2, area->y2, (uint16_t *)&color_p->full);
-  lv_disp_flush_ready( disp_drv );
-}
 /*Read the touchpad*/
 void Lvgl_Touchpad_Read( lv_indev_drv_t * indev_drv, lv_indev_data_t * data )
 {
   // NULL
 }
-void example_increase_lvgl_tick(void *arg)
+/* Bytes pushed to the LCD during the last full second */
+uint32_t Lvgl_Get_Flush_Rate(void)
 {
-    /* Tell LVGL how many milliseconds has elapsed */
-    lv_tick_inc(EXAMPLE_LVGL_TICK_PERIOD_MS);
+  return g_lvgl_instance != nullptr ? g_lvgl_instance->getFlushRate() : 0;
 }
 void Lvgl_Init(void)
 {
-  lv_init();
-  lv_disp_draw_buf_init( &draw_buf, buf1, buf2, LVGL_BUF_LEN);
-
-  /*Initialize the display*/
-  static lv_disp_drv_t disp_drv;
-  lv_disp_drv_init( &disp_drv );
-  /*Change the following line to your display resolution*/
-  disp_drv.hor_res = LVGL_WIDTH;
-  disp_drv.ver_res = LVGL_HEIGHT;
-  disp_drv.flush_cb = Lvgl_Display_LCD;
-  disp_drv.full_refresh = 1;                    /**< 1: Always make the whole screen redrawn*/
-  disp_drv.draw_buf = &draw_buf;
-  lv_disp_drv_register( &disp_drv );
+  Lvgl_Init(LVGLConfig::getDefault());
+}
+void Lvgl_Init(const LVGLConfig& config)
+{
+  if (g_lvgl_instance != nullptr) return;
+
+  g_lvgl_instance = new LVGLDriver(display, config);
+  if (!g_lvgl_instance->begin()) {
+    printf("ERROR: LVGL initialization failed!\r\n");
+    return;
+  }
 
   /*Initialize the (dummy) input device driver*/
   static lv_indev_drv_t indev_drv;
@@ -73,18 +391,15 @@ void Lvgl_Init(void)
   lv_obj_t *label = lv_label_create( lv_scr_act() );
   lv_label_set_text( label, "Hello Ardino and LVGL!");
   lv_obj_align( label, LV_ALIGN_CENTER, 0, 0 );
-
-  const esp_timer_create_args_t lvgl_tick_timer_args = {
-    .callback = &example_increase_lvgl_tick,
-    .name = "lvgl_tick"
-  };
-  esp_timer_handle_t lvgl_tick_timer = NULL;
-  esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer);
-  esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000);
-
 }
-void Timer_Loop(void)
+uint32_t Timer_Loop(void)
 {
-  lv_timer_handler(); /* let the GUI do its work */
-  // delay( 5 );
-}
\ No newline at end of file
+  uint32_t sleep_ms = LVGL_LOOP_MAX_SLEEP_MS;
+  if (g_lvgl_instance != nullptr && g_lvgl_instance->isInitialized()) {
+    sleep_ms = g_lvgl_instance->loop();
+  }
+  // Sleep until the next LVGL timer (capped, this also covers LV_NO_TIMER_READY),
+  // at least 1 ms so lower priority tasks get to run
+  if (sleep_ms > LVGL_LOOP_MAX_SLEEP_MS) sleep_ms = LVGL_LOOP_MAX_SLEEP_MS;
+  return sleep_ms > 0 ? sleep_ms : 1;
+}
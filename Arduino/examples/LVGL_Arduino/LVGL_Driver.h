@@ -5,18 +5,138 @@
 #include <demos/lv_demos.h>
 #include <esp_heap_caps.h>
 #include "Display_ST7789.h"
+#include "LVGLConfig.h"
 
 #define LVGL_WIDTH    (LCD_WIDTH )
 #define LVGL_HEIGHT   LCD_HEIGHT
-#define LVGL_BUF_LEN  (LVGL_WIDTH * LVGL_HEIGHT / 20)
 
-#define EXAMPLE_LVGL_TICK_PERIOD_MS  5
+// ============================================================================
+// Object-Oriented Interface
+// ============================================================================
 
+/**
+ * LVGL Display Driver Class
+ * Connects LVGL to an ST7789Display: draw buffers, flush, area rounding
+ * and merging, timekeeping and refresh statistics
+ */
+class LVGLDriver {
+public:
+    /**
+     * Constructor - Uses default config
+     * @param display Display to flush to (must outlive the driver)
+     */
+    LVGLDriver(ST7789Display& display);
+    /**
+     * Constructor - Uses custom config
+     * @param display Display to flush to (must outlive the driver)
+     * @param config Config structure
+     */
+    LVGLDriver(ST7789Display& display, const LVGLConfig& config);
+    /**
+     * Destructor
+     */
+    ~LVGLDriver();
+
+    // ========== Initialization Methods ==========
+
+    /**
+     * Initialize LVGL, allocate the draw buffers and register the display
+     * If the requested buffers do not fit, the second buffer is dropped
+     * and then the line count is halved until the allocation succeeds.
+     * @return true=success, false=failure
+     */
+    bool begin();
+
+    /**
+     * Let LVGL do its work, call periodically from loop()
+     * @return Milliseconds until the next LVGL timer is due
+     */
+    uint32_t loop();
+
+    // ========== Property Accessors ==========
+
+    /**
+     * Get the registered LVGL display
+     * @return Display object (nullptr before begin())
+     */
+    lv_disp_t* getDisplay() const { return _disp; }
+    /**
+     * Get configuration (resolution filled in after begin())
+     * @return Config structure
+     */
+    const LVGLConfig& getConfig() const { return _config; }
+    /**
+     * Get size of one draw buffer
+     * @return Size (pixels)
+     */
+    uint32_t getBufferSize() const { return _buf_size; }
+    /**
+     * Check if the second draw buffer is in use
+     * @return true=double buffered
+     */
+    bool isDoubleBuffered() const { return _buf2 != nullptr; }
+    /**
+     * Check if flushes use asynchronous DMA transfers
+     * @return true=asynchronous
+     */
+    bool isAsyncFlush() const { return _async_flush; }
+    /**
+     * Get bytes pushed to the LCD during the last full second
+     * @return Rate (bytes/s)
+     */
+    uint32_t getFlushRate() const { return _flush_rate; }
+    /**
+     * Check if initialized
+     * @return true=initialized
+     */
+    bool isInitialized() const { return _initialized; }
+
+private:
+    ST7789Display& _display;
+    LVGLConfig _config;
+    bool _initialized;
+    bool _async_flush;
+
+    // ========== LVGL Objects ==========
+    lv_disp_draw_buf_t _draw_buf;
+    lv_disp_drv_t _disp_drv;
+    lv_disp_t* _disp;
+    lv_color_t* _buf1;
+    lv_color_t* _buf2;
+    uint32_t _buf_size;
+    uint32_t _last_tick;        // millis() already reported to lv_tick_inc()
+
+    // ========== Statistics ==========
+    uint32_t _frame_count;
+    uint32_t _frame_time_sum;
+    uint32_t _frame_time_max;
+    uint32_t _flush_bytes;
+    uint32_t _flush_rate;
+    uint32_t _flush_rate_start;
+
+    // ========== Private Methods ==========
+    bool allocBuffers();
+    void freeBuffers();
+    void flush(const lv_area_t* area, lv_color_t* color_p);
+    void advanceTick();
+
+    // ========== LVGL Callbacks (user_data = this) ==========
+    static void flushCallback(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* color_p);
+    static void waitCallback(lv_disp_drv_t* disp_drv);
+    static void monitorCallback(lv_disp_drv_t* disp_drv, uint32_t time, uint32_t px);
+    static void rounderCallback(lv_disp_drv_t* disp_drv, lv_area_t* area);
+    static void renderStartCallback(lv_disp_drv_t* disp_drv);
+    static void transferDoneCallback(void* user_ctx);
+};
+
+// ============================================================================
+// C-style API (compatibility layer)
+// ============================================================================
 
 void Lvgl_print(const char * buf);
-void Lvgl_Display_LCD( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p ); // Displays LVGL content on the LCD.    This function implements associating LVGL data to the LCD screen
 void Lvgl_Touchpad_Read( lv_indev_drv_t * indev_drv, lv_indev_data_t * data );                // Read the touchpad
-void example_increase_lvgl_tick(void *arg);
+uint32_t Lvgl_Get_Flush_Rate(void);                                                            // Bytes pushed to the LCD during the last second
 
-void Lvgl_Init(void);
-void Timer_Loop(void);
+void Lvgl_Init(void);                                                                          // Initialize with LVGLConfig::getDefault()
+void Lvgl_Init(const LVGLConfig& config);                                                      // Initialize with a custom buffer/refresh strategy
+uint32_t Timer_Loop(void);                                                                     // Run LVGL, returns how long loop() may sleep (ms)
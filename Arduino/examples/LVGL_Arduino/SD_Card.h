@@ -1,10 +1,62 @@
 #pragma once
 #include <Arduino.h>
-#include <SD.h>
 #include <FS.h>
+#include <driver/spi_master.h>
+#include <sdmmc_cmd.h>
 #include <vector>
 #include "SDCardConfig.h"
 
+// The card is a second spi_master device on the LCD bus, which
+// ST7789Display::begin() initializes
+#define SD_SPI_HOST         SPI2_HOST
+#define SD_MAX_FILES        5
+
+/**
+ * Card type, same values as the Arduino SD library
+ */
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+/**
+ * SD card file system over ESP-IDF sdspi
+ * Mounts the card with esp_vfs_fat_sdspi_mount() and exposes it as an
+ * Arduino fs::FS (File, open, exists, remove, rename), like SD_MMC does
+ * for the SDMMC host. Sharing the bus through spi_master lets the LCD
+ * use DMA while the card stays usable.
+ */
+class SDSPIFS : public fs::FS {
+public:
+    SDSPIFS(fs::FSImplPtr impl);
+
+    /**
+     * Mount the card
+     * @param cs_pin Card chip select
+     * @param freq_hz SPI clock, limited to the SD high speed clock
+     * @param mount_point VFS path
+     * @return true=success, false=no card or mount failed
+     */
+    bool begin(uint8_t cs_pin, uint32_t freq_hz, const char* mount_point = "/sd");
+    /**
+     * Unmount the card
+     */
+    void end();
+
+    sdcard_type_t cardType();
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+
+private:
+    sdmmc_card_t* _card;
+};
+
+extern SDSPIFS SDSPI;
+
 // ============================================================================
 // Object-Oriented Interface
 // ============================================================================
@@ -0,0 +1,201 @@
+#include "Buffered_Reader.h"
+#include <inttypes.h>
+
+// ============================================================================
+// BufferedFileReader Class Implementation
+// ============================================================================
+
+/**
+ * Round a byte count up to whole sectors (at least one)
+ */
+static size_t roundToSectors(size_t bytes) {
+    if (bytes < BUFFERED_READER_SECTOR) return BUFFERED_READER_SECTOR;
+    return (bytes + BUFFERED_READER_SECTOR - 1) & ~(size_t)(BUFFERED_READER_SECTOR - 1);
+}
+
+/**
+ * Constructor
+ */
+BufferedFileReader::BufferedFileReader(size_t bufferSize)
+    : _open(false),
+      _buffer(nullptr),
+      _capacity(roundToSectors(bufferSize)),
+      _bufStart(0),
+      _bufLen(0),
+      _filePos(0),
+      _pos(0),
+      _size(0)
+{
+    resetStats();
+}
+
+/**
+ * Destructor
+ */
+BufferedFileReader::~BufferedFileReader() {
+    close();
+    free(_buffer);
+}
+
+/**
+ * Change the read-ahead buffer size
+ */
+bool BufferedFileReader::setBufferSize(size_t bytes) {
+    if (_open) return false;
+    bytes = roundToSectors(bytes);
+    if (bytes != _capacity) {
+        free(_buffer);
+        _buffer = nullptr;
+        _capacity = bytes;
+    }
+    return true;
+}
+
+/**
+ * Open a file
+ */
+bool BufferedFileReader::open(fs::FS& fs, const char* path) {
+    close();
+    if (_buffer == nullptr) {
+        _buffer = (uint8_t*)malloc(_capacity);
+        if (_buffer == nullptr) {
+            printf("ERROR: No memory for a %u byte read buffer\r\n", (unsigned)_capacity);
+            return false;
+        }
+    }
+    _file = fs.open(path);
+    if (!_file) return false;
+
+    _open = true;
+    _size = _file.size();
+    _pos = 0;
+    _filePos = 0;
+    _bufStart = 0;
+    _bufLen = 0;
+    resetStats();
+    return true;
+}
+
+/**
+ * Close the file (the buffer is kept for the next one)
+ */
+void BufferedFileReader::close() {
+    if (_open) {
+        _file.close();
+        _open = false;
+    }
+    _bufLen = 0;
+}
+
+/**
+ * Read from the file at offset, timing the read
+ * @return Bytes read, -1 if the seek failed
+ */
+int32_t BufferedFileReader::readFile(uint32_t offset, uint8_t* dst, uint32_t length) {
+    if (_filePos != offset) {
+        if (!_file.seek(offset)) return -1;
+        _filePos = offset;
+    }
+    uint32_t startTime = micros();
+    int32_t n = _file.read(dst, length);
+    uint32_t elapsed = micros() - startTime;
+
+    _stats.fileReads++;
+    _stats.fileReadUs += elapsed;
+    if (elapsed > _stats.fileReadMaxUs) _stats.fileReadMaxUs = elapsed;
+    if (n > 0) {
+        _stats.bytesRead += n;
+        _filePos += n;
+    }
+    return n;
+}
+
+/**
+ * Refill the buffer from the sector containing the read position
+ * @return true=the read position is buffered
+ */
+bool BufferedFileReader::fill() {
+    _bufStart = _pos & ~(uint32_t)(BUFFERED_READER_SECTOR - 1);
+    uint32_t length = _size - _bufStart < _capacity ? _size - _bufStart : _capacity;
+    int32_t n = readFile(_bufStart, _buffer, length);
+    _bufLen = n > 0 ? n : 0;
+    return _pos < _bufStart + _bufLen;
+}
+
+/**
+ * Read bytes at the current position
+ */
+int32_t BufferedFileReader::read(uint8_t* dst, int32_t length) {
+    _stats.reads++;
+    if (!_open || length <= 0) return 0;
+    _stats.bytesRequested += length;
+    if (_pos >= _size) return 0;
+    if ((uint32_t)length > _size - _pos) length = _size - _pos;
+
+    int32_t total = 0;
+    while (length > 0) {
+        // Buffered bytes first
+        if (_pos >= _bufStart && _pos < _bufStart + _bufLen) {
+            uint32_t n = _bufStart + _bufLen - _pos;
+            if (n > (uint32_t)length) n = length;
+            memcpy(dst, _buffer + (_pos - _bufStart), n);
+            dst += n;
+            _pos += n;
+            total += n;
+            length -= n;
+            continue;
+        }
+
+        // Large requests skip the buffer, up to a sector boundary so the
+        // next refill stays aligned
+        uint32_t end = (_pos + length) & ~(uint32_t)(BUFFERED_READER_SECTOR - 1);
+        if (end > _pos && end - _pos >= _capacity) {
+            uint32_t want = end - _pos;
+            int32_t n = readFile(_pos, dst, want);
+            if (n <= 0) break;
+            dst += n;
+            _pos += n;
+            total += n;
+            length -= n;
+            if ((uint32_t)n < want) break;   // Short read
+            continue;
+        }
+
+        if (!fill()) break;
+    }
+    return total;
+}
+
+/**
+ * Move the read position
+ */
+bool BufferedFileReader::seek(uint32_t position) {
+    _stats.seeks++;
+    if (!_open || position > _size) return false;
+    if (position >= _bufStart && position < _bufStart + _bufLen) {
+        _stats.seeksBuffered++;
+    }
+    _pos = position;
+    return true;
+}
+
+/**
+ * Reset the statistics
+ */
+void BufferedFileReader::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+/**
+ * Print the statistics
+ */
+void BufferedFileReader::printStats(const char* label) const {
+    uint32_t ratio = _stats.bytesRequested ? (uint32_t)(_stats.bytesRead * 100 / _stats.bytesRequested) : 0;
+    uint32_t avgUs = _stats.fileReads ? (uint32_t)(_stats.fileReadUs / _stats.fileReads) : 0;
+    printf("%s: %" PRIu32 " bytes requested in %" PRIu32 " reads, %" PRIu32 " bytes read in %" PRIu32
+           " file reads (%" PRIu32 "%%), %" PRIu32 " us avg / %" PRIu32 " us max per file read, %" PRIu32
+           " of %" PRIu32 " seeks buffered\r\n",
+           label, (uint32_t)_stats.bytesRequested, _stats.reads,
+           (uint32_t)_stats.bytesRead, _stats.fileReads, ratio,
+           avgUs, _stats.fileReadMaxUs, _stats.seeksBuffered, _stats.seeks);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+
+// ============================================================================
+// Configuration Constants
+// ============================================================================
+#define BUFFERED_READER_SECTOR        512     // SD sector size, refills start on a sector boundary
+#define BUFFERED_READER_DEFAULT_SIZE  4096    // Default read-ahead buffer (8 sectors)
+
+/**
+ * Read-ahead reader for a file on the SD card
+ * Small reads (PNGdec asks for a few hundred bytes at a time) are served
+ * from a RAM buffer that is refilled with whole sectors, so the FAT/SPI
+ * command overhead is paid once per buffer instead of once per read.
+ *  - Refills start at the sector containing the read position.
+ *  - Seeks inside the buffered range, backward ones included, only move
+ *    the read position; a seek outside it refills on the next read.
+ *  - Reads of at least a whole buffer go straight to the file.
+ * Not thread-safe: one task at a time.
+ */
+class BufferedFileReader {
+public:
+    /**
+     * Read statistics, since open() or resetStats()
+     */
+    struct Stats {
+        uint32_t reads;             // read() calls
+        uint64_t bytesRequested;    // Bytes asked for by read()
+        uint32_t fileReads;         // Reads from the file (refills and direct reads)
+        uint64_t bytesRead;         // Bytes read from the file
+        uint64_t fileReadUs;        // Time spent in file reads
+        uint32_t fileReadMaxUs;     // Slowest file read
+        uint32_t seeks;             // seek() calls
+        uint32_t seeksBuffered;     // Seeks served from the buffer
+    };
+
+    /**
+     * Constructor
+     * @param bufferSize Read-ahead buffer in bytes, rounded up to whole sectors
+     */
+    explicit BufferedFileReader(size_t bufferSize = BUFFERED_READER_DEFAULT_SIZE);
+    ~BufferedFileReader();
+
+    /**
+     * Change the read-ahead buffer size (only while no file is open)
+     * The buffer is allocated on the next open().
+     * @param bytes Buffer size, rounded up to whole sectors
+     * @return true=success, false=a file is open
+     */
+    bool setBufferSize(size_t bytes);
+    size_t getBufferSize() const { return _capacity; }
+
+    /**
+     * Open a file and reset the statistics
+     * @return true=success, false=file not found or out of memory
+     */
+    bool open(fs::FS& fs, const char* path);
+    void close();
+    bool isOpen() const { return _open; }
+
+    /**
+     * Read bytes at the current position
+     * @return Bytes read, less than length at the end of the file
+     */
+    int32_t read(uint8_t* dst, int32_t length);
+
+    /**
+     * Move the read position
+     * @return true=success, false=beyond the end of the file
+     */
+    bool seek(uint32_t position);
+    uint32_t position() const { return _pos; }
+    uint32_t size() const { return _size; }
+
+    const Stats& getStats() const { return _stats; }
+    void resetStats();
+
+    /**
+     * Print the statistics: bytes read vs requested and file read latency
+     * @param label Prefix of the line
+     */
+    void printStats(const char* label) const;
+
+private:
+    File _file;
+    bool _open;
+    uint8_t* _buffer;
+    size_t _capacity;       // Buffer size
+    uint32_t _bufStart;     // File offset of _buffer[0], sector-aligned
+    uint32_t _bufLen;       // Valid bytes in _buffer
+    uint32_t _filePos;      // Position of _file
+    uint32_t _pos;          // Read position
+    uint32_t _size;
+    Stats _stats;
+
+    int32_t readFile(uint32_t offset, uint8_t* dst, uint32_t length);
+    bool fill();
+};
@@ -1,44 +1,118 @@
 #pragma once
 #include <Arduino.h>
-#include <SPI.h>
+#include <atomic>
+#include <driver/spi_master.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include "DisplayConfig.h"
+#include "ST7789_Init_Table.h"
 
 // ============================================================================
-// 面向对象接口（Object-Oriented Interface）
+// Transfer Configuration
+// ============================================================================
+#define ST7789_SPI_HOST                 SPI2_HOST   // Shared with the SD card (sdspi)
+#define ST7789_SPI_MAX_TRANSFER         (32 * 1024) // Bytes per SPI transaction, longer data is chunked
+#define ST7789_TRANSFER_QUEUE_DEPTH     2           // Queued pixel pushes
+#define ST7789_TRANSFER_TASK_STACK      3072
+#define ST7789_TRANSFER_TASK_PRIORITY   5           // Above loopTask
+
+// CASET/RASET: 1 command byte + 4 parameter bytes each
+#define ST7789_WINDOW_CMD_BYTES         5
+
+// Fill configuration
+#define ST7789_FILL_CHUNK_PIXELS        1024        // DMA fill block (2 KB)
+#define ST7789_PATTERN_MAX_BYTES        64          // Longest fill pattern
+
+// Frame memory rows, the range covered by the vertical scroll definition
+#define ST7789_RAM_ROWS                 320
+
+// ============================================================================
+// Object-Oriented Interface
 // ============================================================================
 
 /**
  * ST7789 LCD Driver Class
- * Provides modern C++ interface with configuration injection and object management
+ * Provides modern C++ interface, supports configuration injection and object management
+ *
+ * The panel is an ESP-IDF spi_master device with DMA on ST7789_SPI_HOST.
+ * begin() initializes that bus; the SD card (SDCardManager) is added to
+ * it as a second device, so spi_master is the only driver of the bus and
+ * serializes the two. CS and DC are driven in software around each
+ * write transaction, which holds the bus for its whole duration.
  */
 class ST7789Display {
 public:
     /**
-     * Constructor - uses default configuration
+     * SPI bus statistics
+     * Counts chip-select transactions and bytes sent, used to measure
+     * the cost of window setup and pixel pushes
+     */
+    struct BusStats {
+        uint32_t transactions;  // Number of CS-low transactions
+        uint32_t commands;      // Number of command bytes (DC low)
+        uint32_t bytes;         // Total bytes sent (commands + data)
+
+        BusStats() : transactions(0), commands(0), bytes(0) {}
+    };
+
+    /**
+     * Asynchronous transfer completion callback
+     * Called from the transfer task once the pixel data is on the wire
+     * @param user_ctx Context pointer passed to drawPixelBufferAsync
+     */
+    typedef void (*TransferDoneCallback)(void* user_ctx);
+
+    /**
+     * Window address cache statistics
+     * Shows how much CASET/RASET traffic the window cache avoided
+     */
+    struct WindowStats {
+        uint32_t windows;        // Window setups requested
+        uint32_t caset_skipped;  // CASET commands skipped (unchanged columns)
+        uint32_t raset_skipped;  // RASET commands skipped (unchanged rows)
+        uint32_t continued;      // Writes continued with RAMWRC
+        uint32_t bytes_saved;    // Command + parameter bytes not sent
+
+        WindowStats() : windows(0), caset_skipped(0), raset_skipped(0),
+                        continued(0), bytes_saved(0) {}
+    };
+
+    /**
+     * Constructor - Uses default config
      */
     ST7789Display();
-    
     /**
-     * Constructor - uses custom configuration
-     * @param config Configuration structure
+     * Constructor - Uses custom config
+     * @param config Config structure
      */
     ST7789Display(const ST7789Config& config);
-    
     /**
      * Destructor
      */
     ~ST7789Display();
-    
+
     // ========== Initialization Methods ==========
-    
+
     /**
      * Initialize display
      * @return true=success, false=failure
      */
     bool begin();
-    
+
+    /**
+     * Enable asynchronous pixel transfers
+     * Must be called after begin(). Pixel data queued with
+     * drawPixelBufferAsync is sent by a dedicated transfer task, which
+     * sleeps while the DMA runs, so the caller keeps the CPU.
+     * @param task_priority Priority of the transfer task
+     * @return true=success, false=failure
+     */
+    bool beginAsync(UBaseType_t task_priority = ST7789_TRANSFER_TASK_PRIORITY);
+
     // ========== Display Operation Methods ==========
-    
+
     /**
      * Set drawing window
      * @param x1 Start X coordinate
@@ -47,9 +121,9 @@ public:
      * @param y2 End Y coordinate
      */
     void setWindow(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
-    
+
     /**
-     * Draw pixel buffer to specified area
+     * Draw pixel buffer to the specified area
      * @param x1 Start X coordinate
      * @param y1 Start Y coordinate
      * @param x2 End X coordinate
@@ -57,40 +131,175 @@ public:
      * @param buffer Pixel data buffer (RGB565 format)
      */
     void drawPixelBuffer(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t* buffer);
-    
+
+    /**
+     * Queue pixel buffer for asynchronous DMA transfer
+     * Returns immediately. The buffer must stay valid until the completion
+     * callback runs; it should be DMA-capable, otherwise spi_master copies
+     * it on every transfer. Falls back to a blocking transfer when async
+     * mode is not enabled.
+     * @param x1 Start X coordinate
+     * @param y1 Start Y coordinate
+     * @param x2 End X coordinate
+     * @param y2 End Y coordinate
+     * @param buffer Pixel data buffer (RGB565 format)
+     * @param user_ctx Context pointer handed to the completion callback
+     * @return true=queued, false=failure
+     */
+    bool drawPixelBufferAsync(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+                              const uint16_t* buffer, void* user_ctx = nullptr);
+
+    /**
+     * Set asynchronous transfer completion callback
+     * @param callback Callback function (nullptr to disable)
+     */
+    void onTransferDone(TransferDoneCallback callback) { _done_cb = callback; }
+
+    /**
+     * Block until all queued asynchronous transfers have completed
+     */
+    void waitForTransfers();
+
+    /**
+     * Fill rectangle with a single color
+     * The window is set once and the color is streamed from a small
+     * repeated block in one transaction. Blocks until the fill is on
+     * the wire.
+     * @param x Start X coordinate
+     * @param y Start Y coordinate
+     * @param w Width (pixels)
+     * @param h Height (pixels)
+     * @param color RGB565 color value (same byte order as pixel buffers)
+     */
+    void fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+    /**
+     * Queue a single color fill for asynchronous transfer
+     * No caller buffer is referenced, so the caller may reuse its memory
+     * immediately. The completion callback runs with user_ctx once done.
+     * Falls back to fillRect when async mode is not enabled.
+     * @param x Start X coordinate
+     * @param y Start Y coordinate
+     * @param w Width (pixels)
+     * @param h Height (pixels)
+     * @param color RGB565 color value (same byte order as pixel buffers)
+     * @param user_ctx Context pointer handed to the completion callback
+     * @return true=queued, false=failure
+     */
+    bool fillRectAsync(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                       uint16_t color, void* user_ctx = nullptr);
+
+    /**
+     * Fill rectangle with a repeating pixel pattern
+     * The pattern is repeated in raster order over the whole area, e.g. a
+     * 2-pixel pattern on an odd width gives a checkerboard.
+     * @param x Start X coordinate
+     * @param y Start Y coordinate
+     * @param w Width (pixels)
+     * @param h Height (pixels)
+     * @param pattern Pattern pixels (RGB565 format)
+     * @param pattern_len Number of pattern pixels (max ST7789_PATTERN_MAX_BYTES / 2)
+     * @return true=success, false=pattern too long
+     */
+    bool fillPattern(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                     const uint16_t* pattern, uint8_t pattern_len);
+
     /**
      * Clear screen (fill with single color)
      * @param color RGB565 color value
      */
     void clearScreen(uint16_t color);
-    
+
+    // ========== Hardware Scrolling Methods ==========
+
+    /**
+     * Define the vertical scroll area (VSCRDEF)
+     * Splits the frame memory rows into a fixed top, a scrolling middle
+     * and a fixed bottom. Frame memory rows are screen rows + offset_y
+     * when horizontal is set; otherwise they run along the screen width
+     * and the content scrolls sideways.
+     * @param top_fixed Rows fixed at the top
+     * @param scroll_lines Rows in the scroll area
+     * @param bottom_fixed Rows fixed at the bottom
+     * @return true=success, false=the three don't add up to ST7789_RAM_ROWS
+     */
+    bool setScrollArea(uint16_t top_fixed, uint16_t scroll_lines, uint16_t bottom_fixed);
+
+    /**
+     * Set the vertical scroll start address (VSCSAD)
+     * The panel shows frame memory row line at the top of the scroll area
+     * and wraps around within it. Only the rows that came into view need
+     * to be redrawn afterwards; they are the rows that just left the
+     * other edge.
+     * @param line Frame memory row, top_fixed .. top_fixed + scroll_lines - 1
+     */
+    void setScrollStart(uint16_t line);
+
     // ========== Backlight Control Methods ==========
-    
+
     /**
      * Set backlight brightness
-     * @param brightness Brightness value 0-100
+     * @param brightness value 0-100
      */
     void setBacklight(uint8_t brightness);
-    
-    // ========== Property Getter Methods ==========
-    
+
+    // ========== Property Accessors ==========
+
     /**
      * Get screen width
      * @return Width (pixels)
      */
     uint16_t width() const { return _width; }
-    
     /**
      * Get screen height
      * @return Height (pixels)
      */
     uint16_t height() const { return _height; }
-    
     /**
      * Check if initialized
      * @return true=initialized
      */
     bool isInitialized() const { return _initialized; }
+    /**
+     * Check if asynchronous transfers are enabled
+     * @return true=enabled
+     */
+    bool isAsyncEnabled() const { return _async; }
+    /**
+     * Get time spent in begin(), from reset to display on
+     * @return Time (microseconds)
+     */
+    uint32_t getInitTimeUs() const { return _init_time_us; }
+    /**
+     * Get SPI bus statistics since the last reset
+     * @return Statistics structure
+     */
+    BusStats getBusStats() const { return _stats; }
+    /**
+     * Reset SPI bus statistics
+     */
+    void resetBusStats() { _stats = BusStats(); }
+    /**
+     * Get window address cache statistics since the last reset
+     * @return Statistics structure
+     */
+    WindowStats getWindowStats() const { return _window_stats; }
+    /**
+     * Reset window address cache statistics
+     */
+    void resetWindowStats() { _window_stats = WindowStats(); }
+    /**
+     * Forget the cached window, forcing a full CASET/RASET on the next draw
+     * Call after sending raw commands that change addressing (e.g. MADCTL)
+     */
+    void invalidateWindow() { _window = WindowCache(); }
+
+protected:
+    // ========== Single Write Methods (one transaction each) ==========
+    void writeCommand(uint8_t cmd);
+    void writeData(uint8_t data);
+    void writeData16(uint16_t data);
+    void writeDataBytes(uint8_t* data, uint32_t len);
 
 private:
     // ========== Configuration Parameters ==========
@@ -106,15 +315,65 @@ private:
     uint32_t _spi_freq;
     uint16_t _backlight_freq;
     uint8_t _backlight_resolution;
-    
+
     bool _initialized;
-    
+    BusStats _stats;
+    uint32_t _cmd_ready_us;     // Earliest micros() for the next command after reset/sleep out
+    uint32_t _init_time_us;
+
+    // ========== Window Address Cache ==========
+    struct WindowCache {
+        bool valid;              // CASET/RASET registers hold the values below
+        bool cursor_valid;       // Address counter sits at the start of next_row
+        uint16_t col_start;
+        uint16_t col_end;
+        uint16_t row_start;
+        uint16_t row_end;
+        uint16_t next_row;
+
+        WindowCache() : valid(false), cursor_valid(false), col_start(0), col_end(0),
+                        row_start(0), row_end(0), next_row(0) {}
+    };
+
+    WindowCache _window;
+    WindowStats _window_stats;
+
+    // ========== SPI Device ==========
+    spi_device_handle_t _spi;
+    uint16_t* _fill_buf;                // DMA-capable fill block
+
+    // ========== Asynchronous Transfer State ==========
+    struct TransferJob {
+        uint16_t x1;
+        uint16_t y1;
+        uint16_t x2;
+        uint16_t y2;
+        const uint16_t* buffer;     // nullptr for a solid fill
+        uint16_t fill_color;
+        void* user_ctx;
+    };
+
+    bool _async;
+    QueueHandle_t _job_queue;
+    SemaphoreHandle_t _done_sem;
+    TaskHandle_t _transfer_task;
+    std::atomic<uint32_t> _pending;
+    TransferDoneCallback _done_cb;
+
     // ========== Private Hardware Operation Methods ==========
-    void spiInit();
-    void writeCommand(uint8_t cmd);
-    void writeData(uint8_t data);
-    void writeData16(uint16_t data);
-    void writeDataBytes(uint8_t* data, uint32_t len);
+    bool spiInit();
+    void beginWrite();
+    void endWrite();
+    void sendCommand(uint8_t cmd);
+    void sendData(const uint8_t* data, uint32_t len);
+    void sendWindow(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, bool track);
+    void writeCommandData(uint8_t cmd, const uint8_t* data, uint32_t len);
+    void sendPattern(const uint16_t* pattern, uint8_t pattern_len, uint32_t pixels, bool queued);
+    void sendDataQueued(const uint8_t* data, uint32_t len);
+    bool queueJob(const TransferJob& job);
+    void runTransfer(const TransferJob& job);
+    static void transferTask(void* arg);
+    void waitReady();
     void hardwareReset();
     void initRegisters();
     void backlightInit();
@@ -124,7 +383,7 @@ private:
 // Constants Definition
 // ============================================================================
 
-// Display dimensions
+// Display size
 #define LCD_WIDTH   172
 #define LCD_HEIGHT  320
 
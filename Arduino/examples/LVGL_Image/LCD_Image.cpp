@@ -1,4 +1,7 @@
 #include "LCD_Image.h"
+#include <esp_heap_caps.h>
+#include "Pixel_Ops.h"
+#include "Buffered_Reader.h"
 
 // ============================================================================
 // External References
@@ -10,7 +13,7 @@ extern SDCardManager sdcard;   // Defined in LVGL_Image.ino
 // Module-internal State (Encapsulated Global Variables)
 // ============================================================================
 static PNG pngDecoder;                          // PNG decoder instance
-static File currentImageFile;                   // Currently open image file
+static BufferedFileReader imageReader(IMAGE_READ_BUFFER_SIZE);  // PNG and sidecar reads
 static std::vector<String> imageFileList;       // Image file list (using vector instead of a fixed array)
 static String currentDirectory = "";            // Current search directory
 static String currentExtension = "";            // Current file extension
@@ -21,8 +24,54 @@ static uint32_t autoPlayCounter = 0;            // Auto-play counter
 static int16_t imageXPos = 0;
 static int16_t imageYPos = 0;
 
-// Line buffer (for PNG decoding)
-static uint16_t lineBuffer[MAX_IMAGE_WIDTH];
+// Band buffers: decoded rows collected for one display transfer. While
+// one band is sent by DMA the decoder fills the other.
+static uint16_t* bandBuffers[2] = { nullptr, nullptr };
+static uint16_t* bandBuffer = nullptr;          // Band being filled
+static uint8_t bandIndex = 0;                   // Index of bandBuffer in bandBuffers
+static SemaphoreHandle_t bandFree = nullptr;    // Counts bands not on the wire
+static uint32_t bandWaitUs = 0;                 // Time spent waiting for a free band
+static uint16_t bandLines = IMAGE_BAND_LINES;   // Rows per band
+static uint16_t bandRows = 0;                   // Rows collected so far
+static int16_t bandStartY = 0;                  // Image row of the first collected row
+
+// RGB565 sidecar cache
+#define IMAGE_CACHE_FLAG_RLE  0x0001
+
+/**
+ * Sidecar file header, followed by the pixels row by row. Raw rows are
+ * width pixels. RLE rows are a word count followed by that many words of
+ * tokens: 0x8000 | n, color = n times color; n, n pixels = literal.
+ */
+struct ImageCacheHeader {
+    uint32_t magic;         // IMAGE_CACHE_MAGIC
+    uint16_t version;       // IMAGE_CACHE_VERSION
+    uint16_t flags;         // IMAGE_CACHE_FLAG_*
+    uint16_t width;
+    uint16_t height;
+    uint32_t srcSize;       // Size of the image file the pixels came from
+    uint32_t srcMtime;      // Last write time of that file
+};
+
+static bool cacheEnabled = IMAGE_CACHE_ENABLED;
+static bool cacheRle = IMAGE_CACHE_RLE;
+static File cacheFile;                          // Sidecar being written during a decode
+static bool cacheWriting = false;               // cacheFile gets every band
+static uint16_t rleRow[MAX_IMAGE_WIDTH + 2];    // One encoded row: count + worst case tokens
+
+// Slideshow prefetch, run by a background task during the dwell time
+static TaskHandle_t prefetchTask = nullptr;
+static SemaphoreHandle_t prefetchDone = nullptr;    // Given when the task has finished a prefetch
+static bool prefetchUnavailable = false;            // Task could not be started, don't try again
+static bool prefetchBusy = false;                   // prefetchDone still to be taken
+static String prefetchPath;                         // Image prefetched (or being prefetched)
+static uint16_t* prefetchFrame = nullptr;           // Off-screen frame, MAX_IMAGE_WIDTH x MAX_IMAGE_HEIGHT
+static bool prefetchFrameReady = false;             // prefetchFrame holds the image at prefetchPath
+static uint16_t prefetchWidth = 0;
+static uint16_t prefetchHeight = 0;
+static uint8_t* prefetchData = nullptr;             // Whole image file, when there is no frame
+static int32_t prefetchSize = 0;
+static uint16_t* frameTarget = nullptr;             // pngDraw decodes into this frame instead of bands
 
 // ============================================================================
 // PNG Decoding Callback Functions
@@ -32,63 +81,186 @@ static uint16_t lineBuffer[MAX_IMAGE_WIDTH];
  * PNG open callback
  */
 void* pngOpen(const char* filePath, int32_t* size) {
-    currentImageFile = SD.open(filePath);
-    if (currentImageFile) {
-        *size = currentImageFile.size();
+    if (imageReader.open(SDSPI, filePath)) {
+        *size = imageReader.size();
     } else {
         *size = 0;
     }
-    return &currentImageFile;
+    return &imageReader;
 }
 
 /**
  * PNG close callback
  */
 void pngClose(void* handle) {
-    File imageFile = *((File*)handle);
-    if (imageFile) {
-        imageFile.close();
-    }
+    ((BufferedFileReader*)handle)->close();
 }
 
 /**
  * PNG read callback
  */
 int32_t pngRead(PNGFILE* page, uint8_t* buffer, int32_t length) {
-    if (!currentImageFile) return 0;
-    (void)page; // Avoid unused parameter warning
-    return currentImageFile.read(buffer, length);
+    return ((BufferedFileReader*)page->fHandle)->read(buffer, length);
 }
 
 /**
  * PNG seek callback
  */
 int32_t pngSeek(PNGFILE* page, int32_t position) {
-    if (!currentImageFile) return 0;
-    (void)page; // Avoid unused parameter warning
-    return currentImageFile.seek(position);
+    return ((BufferedFileReader*)page->fHandle)->seek(position);
+}
+
+/**
+ * Transfer done callback (transfer task context): the band is free again
+ */
+static void bandTransferDone(void* user_ctx) {
+    if (user_ctx == bandFree) {
+        xSemaphoreGive(bandFree);
+    }
+}
+
+/**
+ * Start a band: wait until the band sent two bands ago is off the wire
+ * @param y Image row of the first row in the band
+ */
+static void beginBand(int16_t y) {
+    uint32_t waitStart = micros();
+    xSemaphoreTake(bandFree, portMAX_DELAY);
+    bandWaitUs += micros() - waitStart;
+    bandBuffer = bandBuffers[bandIndex];
+    bandStartY = y;
+    bandRows = 0;
+}
+
+/**
+ * Give up a started band without sending it
+ */
+static void abortBand() {
+    if (bandBuffer != nullptr) {
+        xSemaphoreGive(bandFree);
+        bandBuffer = nullptr;
+    }
+    bandRows = 0;
+}
+
+/**
+ * Run-length encode one row into rleRow
+ * Runs of 3 or more pixels become run tokens, everything else literals.
+ * @return Words used in rleRow, including the leading count
+ */
+static uint16_t rleEncodeRow(const uint16_t* px, int n) {
+    uint16_t w = 1;
+    int i = 0;
+    while (i < n) {
+        int run = 1;
+        while (i + run < n && px[i + run] == px[i]) run++;
+        if (run >= 3) {
+            rleRow[w++] = 0x8000 | run;
+            rleRow[w++] = px[i];
+            i += run;
+            continue;
+        }
+        int start = i;
+        while (i < n && !(i + 2 < n && px[i] == px[i + 1] && px[i] == px[i + 2])) i++;
+        rleRow[w++] = i - start;
+        memcpy(&rleRow[w], &px[start], (i - start) * sizeof(uint16_t));
+        w += i - start;
+    }
+    rleRow[0] = w - 1;
+    return w;
+}
+
+/**
+ * Expand one RLE row
+ * @return true=the tokens cover exactly n pixels
+ */
+static bool rleDecodeRow(uint16_t* dst, const uint16_t* tokens, uint16_t words, int n) {
+    int x = 0;
+    uint16_t i = 0;
+    while (i < words) {
+        uint16_t count = tokens[i] & 0x7FFF;
+        bool run = tokens[i++] & 0x8000;
+        if (x + count > n || i + (run ? 1 : count) > words) return false;
+        if (run) {
+            pixel_fill565(dst + x, tokens[i++], count);
+        } else {
+            memcpy(dst + x, &tokens[i], count * sizeof(uint16_t));
+            i += count;
+        }
+        x += count;
+    }
+    return x == n;
+}
+
+/**
+ * Append rows to the sidecar being written
+ * A failed write only drops the sidecar, the image is still shown.
+ */
+static void writeCacheRows(const uint16_t* px, uint16_t rows, int width) {
+    bool ok = true;
+    if (!cacheRle) {
+        size_t bytes = (size_t)rows * width * sizeof(uint16_t);
+        ok = cacheFile.write((const uint8_t*)px, bytes) == bytes;
+    } else {
+        for (uint16_t r = 0; r < rows && ok; r++) {
+            size_t bytes = rleEncodeRow(px + r * width, width) * sizeof(uint16_t);
+            ok = cacheFile.write((const uint8_t*)rleRow, bytes) == bytes;
+        }
+    }
+    if (!ok) {
+        printf("WARNING: Sidecar write failed, image stays uncached\r\n");
+        cacheWriting = false;
+    }
+}
+
+/**
+ * Queue the collected rows to the LCD with one window setup
+ * The decoder continues in the other band while this one is sent.
+ * @param width Image width (pixels), the row stride of the band
+ */
+static void flushBand(int width) {
+    if (bandRows == 0) return;
+    if (cacheWriting) {
+        writeCacheRows(bandBuffer, bandRows, width);
+    }
+    if (!display.drawPixelBufferAsync(imageXPos,
+                                      imageYPos + bandStartY,
+                                      imageXPos + width - 1,
+                                      imageYPos + bandStartY + bandRows - 1,
+                                      bandBuffer, bandFree)) {
+        xSemaphoreGive(bandFree);   // Not queued, no callback will come
+    }
+    bandIndex ^= 1;
+    bandBuffer = nullptr;
+    bandRows = 0;
 }
 
 /**
  * PNG draw callback
- * Called for each decoded line of PNG data, used to render the data to the LCD
+ * Called for each decoded line of PNG data; rows are collected in the
+ * band buffer and sent to the LCD once the band is full
  */
 void pngDraw(PNGDRAW* pDraw) {
-    // Convert PNG data to RGB565 format
-    pngDecoder.getLineAsRGB565(pDraw, lineBuffer, PNG_RGB565_BIG_ENDIAN, 0xffffffff);
-    
-    // Byte order conversion (big-endian to little-endian)
-    uint32_t pixelCount = pDraw->iWidth;
-    for (uint32_t i = 0; i < pixelCount; i++) {
-        lineBuffer[i] = ((lineBuffer[i] >> 8) & 0xFF) | ((lineBuffer[i] << 8) & 0xFF00);
+    // Prefetch: decode into the off-screen frame, nothing is sent
+    if (frameTarget != nullptr) {
+        pngDecoder.getLineAsRGB565(pDraw, frameTarget + pDraw->y * pDraw->iWidth,
+                                   PNG_RGB565_LITTLE_ENDIAN, 0xffffffff);
+        return;
+    }
+
+    if (bandRows == 0) {
+        beginBand(pDraw->y);
+    }
+
+    // Convert PNG data to RGB565 in the panel's byte order. RAMCTRL in
+    // ST7789_Init_Table.h puts the panel in little-endian mode, so the
+    // decoder output goes to the LCD as is, no per-pixel swap.
+    uint16_t* row = bandBuffer + bandRows * pDraw->iWidth;
+    pngDecoder.getLineAsRGB565(pDraw, row, PNG_RGB565_LITTLE_ENDIAN, 0xffffffff);
+
+    if (++bandRows == bandLines) {
+        flushBand(pDraw->iWidth);
     }
-    
-    // Draw to LCD (using OOP API)
-    display.drawPixelBuffer(imageXPos, 
-                            pDraw->y, 
-                            imageXPos + pDraw->iWidth - 1, 
-                            imageYPos + pDraw->y, 
-                            lineBuffer);
 }
 
 // ============================================================================
@@ -111,10 +283,428 @@ static String buildFilePath(const char* directory, const char* filename) {
     return path;
 }
 
+/**
+ * Allocate both band buffers (one block) for the current band height
+ * @return true=buffers available
+ */
+static bool allocBandBuffer() {
+    if (bandFree == nullptr) {
+        bandFree = xSemaphoreCreateCounting(2, 2);
+        if (bandFree == nullptr) return false;
+        display.onTransferDone(bandTransferDone);
+    }
+    if (bandBuffers[0] != nullptr) return true;
+
+    size_t bandPixels = (size_t)MAX_IMAGE_WIDTH * bandLines;
+    bandBuffers[0] = (uint16_t*)heap_caps_malloc(2 * bandPixels * sizeof(uint16_t),
+                                                 MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    if (bandBuffers[0] == nullptr) return false;
+    bandBuffers[1] = bandBuffers[0] + bandPixels;
+    return true;
+}
+
+/**
+ * Read size and last write time of an image file
+ * @return true=file exists
+ */
+static bool statImage(const char* filePath, uint32_t* size, uint32_t* mtime) {
+    File f = SDSPI.open(filePath);
+    if (!f) return false;
+    *size = f.size();
+    *mtime = (uint32_t)f.getLastWrite();
+    f.close();
+    return true;
+}
+
+/**
+ * Open the sidecar of an image if it is still valid
+ * @param cache Returned sidecar, positioned at the first row
+ * @param hdr Returned header
+ * @return true=sidecar matches the image file
+ */
+static bool openCache(const char* filePath, BufferedFileReader& cache, ImageCacheHeader& hdr) {
+    String cachePath = String(filePath) + IMAGE_CACHE_EXT;
+    if (!SDSPI.exists(cachePath)) return false;
+
+    uint32_t srcSize, srcMtime;
+    bool valid = cache.open(SDSPI, cachePath.c_str()) &&
+                 cache.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+                 hdr.magic == IMAGE_CACHE_MAGIC && hdr.version == IMAGE_CACHE_VERSION &&
+                 hdr.width > 0 && hdr.width <= MAX_IMAGE_WIDTH && hdr.height > 0 &&
+                 statImage(filePath, &srcSize, &srcMtime) &&
+                 hdr.srcSize == srcSize && hdr.srcMtime == srcMtime;
+    if (valid && !(hdr.flags & IMAGE_CACHE_FLAG_RLE)) {
+        valid = cache.size() == sizeof(hdr) + (size_t)hdr.width * hdr.height * sizeof(uint16_t);
+    }
+    if (!valid) {
+        cache.close();
+        printf("Sidecar stale, decoding image\r\n");
+    }
+    return valid;
+}
+
+/**
+ * Read the next rows of a sidecar
+ * @param dst Destination, rows * hdr.width pixels
+ * @return true=all rows read and (for RLE) well-formed
+ */
+static bool readCacheRows(BufferedFileReader& cache, const ImageCacheHeader& hdr, uint16_t* dst, uint16_t rows) {
+    if (!(hdr.flags & IMAGE_CACHE_FLAG_RLE)) {
+        size_t bytes = (size_t)rows * hdr.width * sizeof(uint16_t);
+        return cache.read((uint8_t*)dst, bytes) == (int)bytes;
+    }
+    for (uint16_t r = 0; r < rows; r++) {
+        uint16_t words;
+        bool ok = cache.read((uint8_t*)&words, sizeof(words)) == sizeof(words) &&
+                  words < sizeof(rleRow) / sizeof(rleRow[0]) &&
+                  cache.read((uint8_t*)rleRow, words * sizeof(uint16_t)) == (int)(words * sizeof(uint16_t)) &&
+                  rleDecodeRow(dst + r * hdr.width, rleRow, words, hdr.width);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+/**
+ * Stream a valid sidecar to the display
+ * @return true=image shown from the sidecar, false=decode the image instead
+ */
+static bool showCachedImage(const char* filePath) {
+    BufferedFileReader& cache = imageReader;
+    ImageCacheHeader hdr;
+    if (!openCache(filePath, cache, hdr)) return false;
+
+    uint32_t startTime = millis();
+    bandWaitUs = 0;
+    bool ok = true;
+    for (int y = 0; y < hdr.height && ok; y += bandLines) {
+        uint16_t rows = hdr.height - y < bandLines ? hdr.height - y : bandLines;
+        beginBand(y);
+        ok = readCacheRows(cache, hdr, bandBuffer, rows);
+        if (!ok) {
+            abortBand();
+            break;
+        }
+        bandRows = rows;
+        flushBand(hdr.width);
+    }
+    display.waitForTransfers();
+    cache.close();
+
+    if (!ok) {
+        printf("Sidecar read failed, decoding image\r\n");
+        SDSPI.remove(String(filePath) + IMAGE_CACHE_EXT);
+        return false;
+    }
+    printf("Sidecar time: %u ms (%s, %u ms waiting for the LCD)\r\n", (unsigned)(millis() - startTime),
+           (hdr.flags & IMAGE_CACHE_FLAG_RLE) ? "RLE" : "raw RGB565", (unsigned)(bandWaitUs / 1000));
+    cache.printStats("Sidecar reads");
+    return true;
+}
+
+/**
+ * Start writing a sidecar for the image about to be decoded
+ * Pixels go to a temporary file that only replaces the sidecar once the
+ * whole image has been written.
+ */
+static void beginCacheWrite(const char* filePath, uint16_t width, uint16_t height) {
+    ImageCacheHeader hdr = {};
+    hdr.magic = IMAGE_CACHE_MAGIC;
+    hdr.version = IMAGE_CACHE_VERSION;
+    hdr.flags = cacheRle ? IMAGE_CACHE_FLAG_RLE : 0;
+    hdr.width = width;
+    hdr.height = height;
+    if (!statImage(filePath, &hdr.srcSize, &hdr.srcMtime)) return;
+
+    String tmpPath = String(filePath) + IMAGE_CACHE_EXT + ".tmp";
+    cacheFile = SDSPI.open(tmpPath, FILE_WRITE);
+    if (!cacheFile) return;
+    cacheWriting = cacheFile.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+}
+
+/**
+ * Finish the sidecar: keep it if the decode and all writes succeeded
+ */
+static void endCacheWrite(const char* filePath, bool decoded) {
+    if (!cacheFile) return;
+    bool keep = cacheWriting && decoded;
+    cacheFile.close();
+    cacheWriting = false;
+
+    String cachePath = String(filePath) + IMAGE_CACHE_EXT;
+    String tmpPath = cachePath + ".tmp";
+    if (keep) {
+        SDSPI.remove(cachePath);
+        keep = SDSPI.rename(tmpPath, cachePath);
+    }
+    if (!keep) {
+        SDSPI.remove(tmpPath);
+    }
+    printf("Sidecar %s: %s\r\n", keep ? "written" : "dropped", cachePath.c_str());
+}
+
+/**
+ * Decode a PNG and send it to the display band by band
+ * @param filePath Image path (sidecar name, and the source unless data is set)
+ * @param data Whole PNG file in RAM, nullptr to read it from SD
+ * @param size Size of data
+ * @return true=success, false=failure
+ */
+static bool decodePng(const char* filePath, uint8_t* data, int32_t size) {
+    // Open the PNG file, or the copy of it in RAM
+    int16_t result = data != nullptr ? pngDecoder.openRAM(data, size, pngDraw)
+                                     : pngDecoder.open(filePath, pngOpen, pngClose, pngRead, pngSeek, pngDraw);
+    
+    if (result == PNG_SUCCESS) {
+        printf("Image specs: (%d x %d), %d bpp, pixel type: %d\r\n", 
+               pngDecoder.getWidth(), 
+               pngDecoder.getHeight(), 
+               pngDecoder.getBpp(), 
+               pngDecoder.getPixelType());
+        
+        // Check image width
+        if (pngDecoder.getWidth() > MAX_IMAGE_WIDTH) {
+            printf("ERROR: Image width (%d) exceeds buffer size (%d)\r\n", 
+                   pngDecoder.getWidth(), MAX_IMAGE_WIDTH);
+            pngDecoder.close();
+            return false;
+        }
+        
+        // Decode and display; the time includes the last band's transfer
+        uint32_t startTime = millis();
+        bandRows = 0;
+        bandWaitUs = 0;
+        if (cacheEnabled) {
+            beginCacheWrite(filePath, pngDecoder.getWidth(), pngDecoder.getHeight());
+        }
+        result = pngDecoder.decode(NULL, 0);
+        flushBand(pngDecoder.getWidth());   // Last, partial band
+        display.waitForTransfers();
+        pngDecoder.close();
+        endCacheWrite(filePath, result == PNG_SUCCESS);
+        
+        uint32_t decodeTime = millis() - startTime;
+        printf("Decode time: %u ms (%d-line bands, %s, %u ms waiting for the LCD)\r\n",
+               (unsigned)decodeTime, bandLines, display.isAsyncEnabled() ? "DMA overlapped" : "blocking",
+               (unsigned)(bandWaitUs / 1000));
+        if (data == nullptr) {
+            imageReader.printStats("PNG reads");
+        }
+        
+        return true;
+    } else {
+        printf("ERROR: Failed to open PNG file (error code: %d)\r\n", result);
+        return false;
+    }
+}
+
+/**
+ * Prepare an image for display without touching the LCD (prefetch task)
+ * Decodes it into the off-screen frame, from its sidecar if valid, or
+ * else keeps a copy of the file in RAM for a decode without SD access.
+ */
+static void prefetchImage(const char* filePath) {
+    if (prefetchFrame != nullptr) {
+        BufferedFileReader& cache = imageReader;
+        ImageCacheHeader hdr;
+        if (cacheEnabled && openCache(filePath, cache, hdr)) {
+            if (hdr.height <= MAX_IMAGE_HEIGHT) {
+                prefetchFrameReady = readCacheRows(cache, hdr, prefetchFrame, hdr.height);
+                prefetchWidth = hdr.width;
+                prefetchHeight = hdr.height;
+            }
+            cache.close();
+            if (prefetchFrameReady) return;
+        }
+
+        if (pngDecoder.open(filePath, pngOpen, pngClose, pngRead, pngSeek, pngDraw) == PNG_SUCCESS) {
+            uint16_t width = pngDecoder.getWidth();
+            uint16_t height = pngDecoder.getHeight();
+            if (width <= MAX_IMAGE_WIDTH && height <= MAX_IMAGE_HEIGHT) {
+                frameTarget = prefetchFrame;
+                prefetchFrameReady = pngDecoder.decode(NULL, 0) == PNG_SUCCESS;
+                frameTarget = nullptr;
+                prefetchWidth = width;
+                prefetchHeight = height;
+            }
+            pngDecoder.close();
+            if (prefetchFrameReady && cacheEnabled) {
+                beginCacheWrite(filePath, width, height);
+                if (cacheWriting) {
+                    writeCacheRows(prefetchFrame, height, width);
+                }
+                endCacheWrite(filePath, true);
+            }
+            if (prefetchFrameReady) return;
+        }
+    }
+
+    File f = SDSPI.open(filePath);
+    if (!f) return;
+    int32_t size = f.size();
+    if (heap_caps_get_free_size(MALLOC_CAP_8BIT) >= (size_t)size + IMAGE_PREFETCH_HEAP_RESERVE) {
+        prefetchData = (uint8_t*)malloc(size);
+    }
+    if (prefetchData != nullptr) {
+        if (f.read(prefetchData, size) == size) {
+            prefetchSize = size;
+        } else {
+            free(prefetchData);
+            prefetchData = nullptr;
+        }
+    }
+    f.close();
+}
+
+/**
+ * Prefetch task: prepares prefetchPath whenever it is notified
+ */
+static void prefetchTaskMain(void* arg) {
+    (void)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t startTime = millis();
+        prefetchImage(prefetchPath.c_str());
+        printf("Prefetched %s in %u ms (%s)\r\n", prefetchPath.c_str(), (unsigned)(millis() - startTime),
+               prefetchFrameReady ? "decoded frame" : prefetchData != nullptr ? "file in RAM" : "failed");
+        xSemaphoreGive(prefetchDone);
+    }
+}
+
+/**
+ * Wait until the prefetch task is idle
+ */
+static void waitPrefetch() {
+    if (prefetchBusy) {
+        xSemaphoreTake(prefetchDone, portMAX_DELAY);
+        prefetchBusy = false;
+    }
+}
+
+/**
+ * Start preparing an image in the background
+ * The frame is allocated on first use, only if it leaves
+ * IMAGE_PREFETCH_HEAP_RESERVE free; otherwise the file is kept in RAM.
+ * If the task cannot be started, prefetch stays off.
+ */
+static void startPrefetch(const String& filePath) {
+    waitPrefetch();
+    prefetchFrameReady = false;
+    free(prefetchData);
+    prefetchData = nullptr;
+    prefetchSize = 0;
+    if (prefetchUnavailable) return;
+
+    if (prefetchTask == nullptr) {
+        size_t frameBytes = (size_t)MAX_IMAGE_WIDTH * MAX_IMAGE_HEIGHT * sizeof(uint16_t);
+        if (prefetchFrame == nullptr &&
+            heap_caps_get_free_size(MALLOC_CAP_DMA) >= frameBytes + IMAGE_PREFETCH_HEAP_RESERVE) {
+            prefetchFrame = (uint16_t*)heap_caps_malloc(frameBytes, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        }
+        prefetchDone = xSemaphoreCreateBinary();
+        if (prefetchDone == nullptr ||
+            xTaskCreate(prefetchTaskMain, "img_prefetch", IMAGE_PREFETCH_TASK_STACK, nullptr,
+                        IMAGE_PREFETCH_TASK_PRIORITY, &prefetchTask) != pdPASS) {
+            printf("WARNING: Image prefetch unavailable\r\n");
+            // Give the memory back, images are then decoded on demand only
+            if (prefetchDone != nullptr) {
+                vSemaphoreDelete(prefetchDone);
+                prefetchDone = nullptr;
+            }
+            free(prefetchFrame);
+            prefetchFrame = nullptr;
+            prefetchTask = nullptr;
+            prefetchUnavailable = true;
+            return;
+        }
+        printf("Image prefetch: %s\r\n", prefetchFrame != nullptr ? "off-screen frame" : "file in RAM");
+    }
+
+    prefetchPath = filePath;
+    prefetchBusy = true;
+    xTaskNotifyGive(prefetchTask);
+}
+
+/**
+ * Show an image from the prefetch, if it is the one prefetched
+ * @param how Returned description of the path taken
+ * @return true=shown, false=not prefetched
+ */
+static bool showPrefetched(const String& filePath, const char** how) {
+    waitPrefetch();
+    if (prefetchPath != filePath) return false;
+
+    if (prefetchFrameReady) {
+        // One transfer of the whole frame; the frame is DMA-capable
+        display.drawPixelBufferAsync(imageXPos, imageYPos,
+                                     imageXPos + prefetchWidth - 1, imageYPos + prefetchHeight - 1,
+                                     prefetchFrame);
+        display.waitForTransfers();
+        *how = "prefetched frame";
+        return true;
+    }
+    if (prefetchData != nullptr) {
+        *how = "prefetched file";
+        if (!allocBandBuffer()) {
+            printf("ERROR: No memory for the image band buffer\r\n");
+            return false;
+        }
+        return decodePng(filePath.c_str(), prefetchData, prefetchSize);
+    }
+    return false;
+}
+
 // ============================================================================
 // Public Interface Implementation
 // ============================================================================
 
+/**
+ * Configure the RGB565 sidecar cache
+ */
+void setImageCache(bool enable, bool rle) {
+    cacheEnabled = enable;
+    cacheRle = rle;
+}
+
+/**
+ * Set the read-ahead buffer for image files
+ */
+bool setImageReadBuffer(size_t bytes) {
+    waitPrefetch();
+    return imageReader.setBufferSize(bytes);
+}
+
+/**
+ * Set how many decoded rows are sent per transfer
+ */
+bool setImageBandLines(uint16_t lines) {
+    if (lines == 0) return false;
+    if (lines == bandLines && bandBuffers[0] != nullptr) return true;
+
+    display.waitForTransfers();     // A band may still be on the wire
+    uint16_t* previous = bandBuffers[0];
+    uint16_t previousLines = bandLines;
+    bandBuffers[0] = nullptr;
+    bandLines = lines;
+    if (!allocBandBuffer()) {
+        printf("ERROR: No memory for %d-line image bands\r\n", lines);
+        bandBuffers[0] = previous;
+        if (previous != nullptr) {
+            bandBuffers[1] = previous + (size_t)MAX_IMAGE_WIDTH * previousLines;
+        }
+        bandLines = previousLines;
+        return false;
+    }
+    free(previous);
+    return true;
+}
+
+/**
+ * Get the number of decoded rows sent per transfer
+ */
+uint16_t getImageBandLines() {
+    return bandLines;
+}
+
 /**
  * Search for image files in the specified directory
  */
@@ -146,37 +736,20 @@ uint16_t searchImages(const char* directory, const char* fileExtension) {
 bool showImage(const char* filePath) {
     printf("Displaying image: %s\r\n", filePath);
     
-    // Open the PNG file
-    int16_t result = pngDecoder.open(filePath, pngOpen, pngClose, pngRead, pngSeek, pngDraw);
+    if (!allocBandBuffer()) {
+        printf("ERROR: No memory for the image band buffer\r\n");
+        return false;
+    }
     
-    if (result == PNG_SUCCESS) {
-        printf("Image specs: (%d x %d), %d bpp, pixel type: %d\r\n", 
-               pngDecoder.getWidth(), 
-               pngDecoder.getHeight(), 
-               pngDecoder.getBpp(), 
-               pngDecoder.getPixelType());
-        
-        // Check image width
-        if (pngDecoder.getWidth() > MAX_IMAGE_WIDTH) {
-            printf("ERROR: Image width (%d) exceeds buffer size (%d)\r\n", 
-                   pngDecoder.getWidth(), MAX_IMAGE_WIDTH);
-            pngDecoder.close();
-            return false;
-        }
-        
-        // Decode and display
-        uint32_t startTime = millis();
-        result = pngDecoder.decode(NULL, 0);
-        pngDecoder.close();
-        
-        uint32_t decodeTime = millis() - startTime;
-        printf("Decode time: %u ms\r\n", decodeTime);
-        
+    // The prefetch task shares the decoder and the SD card
+    waitPrefetch();
+    
+    // A valid sidecar skips the PNG decoder entirely
+    if (cacheEnabled && showCachedImage(filePath)) {
         return true;
-    } else {
-        printf("ERROR: Failed to open PNG file (error code: %d)\r\n", result);
-        return false;
     }
+    
+    return decodePng(filePath, nullptr, 0);
 }
 
 /**
@@ -229,7 +802,22 @@ void autoPlayImages(const char* directory, const char* fileExtension, uint32_t i
             currentImageIndex = 0;  // Loop back to the first image
         }
         
-        displayImage(directory, fileExtension, currentImageIndex);
+        uint32_t switchStart = millis();
+        const char* how = "not prefetched";
+        if (imageFileList.empty() ||
+            !showPrefetched(buildFilePath(directory, imageFileList[currentImageIndex].c_str()), &how)) {
+            displayImage(directory, fileExtension, currentImageIndex);
+        }
+        printf("Switch latency: %u ms (%s)\r\n", (unsigned)(millis() - switchStart), how);
+    }
+    
+    // Spend the dwell time on the image after the current one
+    if (!imageFileList.empty() && !prefetchBusy) {
+        uint16_t nextIndex = (currentImageIndex + 1) % imageFileList.size();
+        String nextPath = buildFilePath(directory, imageFileList[nextIndex].c_str());
+        if (prefetchPath != nextPath) {
+            startPrefetch(nextPath);
+        }
     }
 }
 
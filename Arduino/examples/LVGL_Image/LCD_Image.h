@@ -9,6 +9,21 @@
 // Configuration Constants
 // ============================================================================
 #define MAX_IMAGE_WIDTH  172  // Maximum image width (pixels)
+#define MAX_IMAGE_HEIGHT 320  // Maximum height of a prefetched frame (pixels)
+#define IMAGE_BAND_LINES 16   // Decoded rows sent per transfer (2 bands of 172 x 16 x 2 = 5.5 KB)
+#define IMAGE_READ_BUFFER_SIZE 4096  // Read-ahead for PNG and sidecar reads (whole SD sectors)
+
+// RGB565 sidecar cache: "<image>.565" next to each image
+#define IMAGE_CACHE_ENABLED   1         // Write and use sidecars (setImageCache at runtime)
+#define IMAGE_CACHE_RLE       0         // Run-length encode sidecars (pays off for flat artwork, not photos)
+#define IMAGE_CACHE_EXT       ".565"
+#define IMAGE_CACHE_MAGIC     0x35363552  // "R565"
+#define IMAGE_CACHE_VERSION   1
+
+// Slideshow prefetch: the next image is prepared while the current one is shown
+#define IMAGE_PREFETCH_TASK_STACK     4096
+#define IMAGE_PREFETCH_TASK_PRIORITY  1             // Same as loopTask, which mostly sleeps
+#define IMAGE_PREFETCH_HEAP_RESERVE   (32 * 1024)   // Heap left free when sizing prefetch buffers
 
 // ============================================================================
 // Image Management Functions
@@ -40,12 +55,58 @@ bool displayImage(const char* directory, const char* fileExtension, uint16_t ima
 
 /**
  * Auto-play images in a loop
+ * While an image is shown, a background task prepares the next one: it
+ * is decoded into an off-screen frame (172 x 320 x 2 = 110 KB), or, if
+ * that doesn't fit, its file is read into RAM. The switch is then a
+ * single frame transfer, or a decode without SD access. The switch
+ * latency is printed on every switch.
  * @param directory Directory path
  * @param fileExtension File extension
  * @param intervalCount Switch interval (loop count)
  */
 void autoPlayImages(const char* directory, const char* fileExtension, uint32_t intervalCount);
 
+/**
+ * Set the read-ahead buffer used for image and sidecar files
+ * PNGdec reads a few hundred bytes at a time; they are served from a
+ * buffer refilled with whole SD sectors. Short seeks back into the
+ * buffer don't refill it. Bytes read vs requested and the SD read
+ * latency are printed after each image.
+ * @param bytes Buffer size, rounded up to 512-byte sectors
+ * @return true=success (allocated when the next file is opened)
+ */
+bool setImageReadBuffer(size_t bytes);
+
+/**
+ * Set how many decoded rows are sent to the display in one transfer
+ * Each band pays one window setup and transaction instead of one per
+ * row. Two band buffers are used in turn: with display.beginAsync() the
+ * next band is decoded while the previous one is on the wire. Together
+ * they take 2 * MAX_IMAGE_WIDTH * lines * 2 bytes of DMA-capable RAM.
+ * The image module installs its own display.onTransferDone() callback.
+ * @param lines Rows per band (1 = row by row)
+ * @return true=success, false=out of memory (the previous setting stays)
+ */
+bool setImageBandLines(uint16_t lines);
+
+/**
+ * Get the number of decoded rows sent per transfer
+ * @return Rows per band
+ */
+uint16_t getImageBandLines();
+
+/**
+ * Configure the RGB565 sidecar cache
+ * The first display of an image writes its pixels, in the panel's byte
+ * order, to "<image>.565". Later displays stream the sidecar straight to
+ * the panel instead of inflating the PNG. A sidecar is only used while
+ * the size and modification time of the image match the ones recorded
+ * in it, otherwise the PNG is decoded and the sidecar rewritten.
+ * @param enable true=use and write sidecars
+ * @param rle true=write new sidecars run-length encoded
+ */
+void setImageCache(bool enable, bool rle = IMAGE_CACHE_RLE);
+
 /**
  * Get the total number of current images
  * @return Number of images
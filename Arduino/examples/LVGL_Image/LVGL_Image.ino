@@ -37,9 +37,15 @@ void setup()
     printf("ERROR: Display initialization failed!\r\n");
     return;
   }
-  printf("✓ Display initialized: %dx%d\r\n", display.width(), display.height());
+  printf("✓ Display initialized: %dx%d in %u us\r\n", display.width(), display.height(), (unsigned)display.getInitTimeUs());
   display.setBacklight(100);  // 100% brightness
   printf("✓ Backlight set to 100%%\r\n");
+  // DMA transfers let the PNG decoder fill the next band while one is sent
+  if (display.beginAsync()) {
+    printf("✓ Async DMA transfers enabled\r\n");
+  } else {
+    printf("✗ Async DMA transfers unavailable, images are sent blocking\r\n");
+  }
   printf("\r\n");
   
   // 3. Initialize SD Card (using the new object-oriented API)
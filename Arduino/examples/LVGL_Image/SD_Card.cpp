@@ -1,7 +1,114 @@
 #include "SD_Card.h"
+#include <vfs_api.h>
+#include <esp_vfs_fat.h>
+#include <driver/sdspi_host.h>
 
 
 
+// ============================================================================
+// SDSPIFS Class Implementation
+// ============================================================================
+SDSPIFS SDSPI = SDSPIFS(fs::FSImplPtr(new VFSImpl()));
+
+/**
+ * Constructor
+ */
+SDSPIFS::SDSPIFS(fs::FSImplPtr impl)
+    : fs::FS(impl),
+      _card(nullptr)
+{
+}
+
+/**
+ * Mount the card on the shared SPI bus
+ */
+bool SDSPIFS::begin(uint8_t cs_pin, uint32_t freq_hz, const char* mount_point) {
+    if (_card != nullptr) {
+        return true;
+    }
+
+    sdmmc_host_t host = SDSPI_HOST_DEFAULT();
+    host.slot = SD_SPI_HOST;
+    host.max_freq_khz = freq_hz / 1000;
+    if (host.max_freq_khz > SDMMC_FREQ_HIGHSPEED) {
+        host.max_freq_khz = SDMMC_FREQ_HIGHSPEED;
+    }
+
+    sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT();
+    slot_config.gpio_cs = (gpio_num_t)cs_pin;
+    slot_config.host_id = SD_SPI_HOST;
+
+    esp_vfs_fat_sdmmc_mount_config_t mount_config = {};
+    mount_config.format_if_mount_failed = false;
+    mount_config.max_files = SD_MAX_FILES;
+    mount_config.allocation_unit_size = 16 * 1024;
+
+    esp_err_t ret = esp_vfs_fat_sdspi_mount(mount_point, &host, &slot_config, &mount_config, &_card);
+    if (ret != ESP_OK) {
+        printf("SD card mount failed: %s\r\n", esp_err_to_name(ret));
+        _card = nullptr;
+        return false;
+    }
+    _impl->mountpoint(mount_point);
+    return true;
+}
+
+/**
+ * Unmount the card
+ */
+void SDSPIFS::end() {
+    if (_card != nullptr) {
+        esp_vfs_fat_sdcard_unmount(_impl->mountpoint(), _card);
+        _impl->mountpoint(nullptr);
+        _card = nullptr;
+    }
+}
+
+/**
+ * Get card type
+ */
+sdcard_type_t SDSPIFS::cardType() {
+    if (_card == nullptr) {
+        return CARD_NONE;
+    }
+    if (_card->is_mmc) {
+        return CARD_MMC;
+    }
+    return (_card->ocr & SD_OCR_SDHC_CAP) ? CARD_SDHC : CARD_SD;
+}
+
+/**
+ * Get raw card capacity
+ */
+uint64_t SDSPIFS::cardSize() {
+    if (_card == nullptr) {
+        return 0;
+    }
+    return (uint64_t)_card->csd.capacity * _card->csd.sector_size;
+}
+
+/**
+ * Get file system size
+ */
+uint64_t SDSPIFS::totalBytes() {
+    uint64_t total = 0, free_bytes = 0;
+    if (_card == nullptr || esp_vfs_fat_info(_impl->mountpoint(), &total, &free_bytes) != ESP_OK) {
+        return 0;
+    }
+    return total;
+}
+
+/**
+ * Get used file system space
+ */
+uint64_t SDSPIFS::usedBytes() {
+    uint64_t total = 0, free_bytes = 0;
+    if (_card == nullptr || esp_vfs_fat_info(_impl->mountpoint(), &total, &free_bytes) != ESP_OK) {
+        return 0;
+    }
+    return total - free_bytes;
+}
+
 // ============================================================================
 // SDCardManager Class Implementation
 // ============================================================================
@@ -35,12 +142,8 @@ SDCardManager::~SDCardManager() {
  * Initialize SD card
  */
 bool SDCardManager::begin() {
-    // Configure CS pin
-    pinMode(config_.cs_pin, OUTPUT);
-    digitalWrite(config_.cs_pin, HIGH);
-    
-    // Initialize SD card
-    if (!SD.begin(config_.cs_pin, SPI)) {
+    // Mount the card on the LCD's SPI bus (display.begin() must run first)
+    if (!SDSPI.begin(config_.cs_pin, config_.spi_freq, config_.mount_point)) {
         printf("SD card initialization failed!\r\n");
         cardInfo_.available = false;
         initialized_ = true;
@@ -60,7 +163,7 @@ bool SDCardManager::begin() {
  * Update card information
  */
 void SDCardManager::updateCardInfo() {
-    cardInfo_.type = SD.cardType();
+    cardInfo_.type = SDSPI.cardType();
     
     if (cardInfo_.type == CARD_NONE) {
         printf("No SD card attached\r\n");
@@ -69,8 +172,8 @@ void SDCardManager::updateCardInfo() {
     }
     
     // Get capacity information
-    cardInfo_.totalBytes = SD.totalBytes();
-    cardInfo_.usedBytes = SD.usedBytes();
+    cardInfo_.totalBytes = SDSPI.totalBytes();
+    cardInfo_.usedBytes = SDSPI.usedBytes();
     cardInfo_.freeBytes = cardInfo_.totalBytes - cardInfo_.usedBytes;
     cardInfo_.sizeMB = cardInfo_.totalBytes / (1024 * 1024);
     cardInfo_.available = true;
@@ -103,7 +206,7 @@ bool SDCardManager::fileExists(const char* directory, const char* fileName) {
         return false;
     }
     
-    File dir = SD.open(directory);
+    File dir = SDSPI.open(directory);
     if (!dir) {
         printf("Path: <%s> does not exist\r\n", directory);
         return false;
@@ -139,7 +242,7 @@ std::vector<String> SDCardManager::searchFiles(const char* directory,
         return fileList;
     }
     
-    File dir = SD.open(directory);
+    File dir = SDSPI.open(directory);
     if (!dir) {
         printf("Path: <%s> does not exist\r\n", directory);
         return fileList;
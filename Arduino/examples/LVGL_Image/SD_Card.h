@@ -1,10 +1,42 @@
 #pragma once
 #include <Arduino.h>
-#include <SD.h>
 #include <FS.h>
+#include <driver/spi_master.h>
+#include <sdmmc_cmd.h>
 #include <vector>
 #include "SDCardConfig.h"
 
+// The card is a second spi_master device on the LCD bus, which
+// ST7789Display::begin() initializes
+#define SD_SPI_HOST         SPI2_HOST
+#define SD_MAX_FILES        5
+
+// Card type, same values as the Arduino SD library
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+// SD card file system over ESP-IDF sdspi, exposed as an Arduino fs::FS
+// (like SD_MMC for the SDMMC host) so the LCD can share the bus with DMA.
+class SDSPIFS : public fs::FS {
+public:
+    SDSPIFS(fs::FSImplPtr impl);
+    bool begin(uint8_t cs_pin, uint32_t freq_hz, const char* mount_point = "/sd");
+    void end();
+    sdcard_type_t cardType();
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+private:
+    sdmmc_card_t* _card;
+};
+
+extern SDSPIFS SDSPI;
+
 // SD card manager: initialization and file operations.
 class SDCardManager {
 public:
@@ -0,0 +1,89 @@
+/*****************************************************************************
+  | File        :   ST7789_Init_Table.h
+  | Function    :   ST7789 panel init sequence shared by all drivers
+  | Info        :
+    The same file is used by the ESP-IDF panel driver and by the Arduino
+    ST7789Display class, so both bring the panel up with identical power
+    and gamma settings. Keep every copy byte-identical.
+
+    Orientation (MADCTL, LCMCTRL), pixel format (COLMOD) and display on
+    (DISPON) depend on the driver configuration and are sent by the drivers
+    after this table. LCMCTRL is listed with MADCTL because the panel XORs
+    its XBGR/XMX/XMY bits with MADCTL BGR/MX/MY.
+******************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************************
+ * Timing (ST7789 datasheet)
+ ********************************************************************************/
+// Reset pulse width, datasheet minimum is 10 us
+#define ST7789_RESET_PULSE_MS       1
+// Reset release to first command. 5 ms from Sleep In, 120 ms when the reset
+// hits a panel in Sleep Out (e.g. after a soft reboot), so use the worst case
+#define ST7789_RESET_RECOVERY_MS    120
+// Sleep Out to next command
+#define ST7789_SLPOUT_DELAY_MS      5
+
+/********************************************************************************
+ * Table Format
+ ********************************************************************************/
+// Flag in data_bytes: wait delay_ms after this command before the next one
+#define ST7789_INIT_DELAY           0x80
+#define ST7789_INIT_LEN_MASK        0x7F
+#define ST7789_INIT_MAX_PARAMS      14
+
+/**
+ * @brief One init command
+ */
+typedef struct {
+    uint8_t cmd;                                // Command byte
+    uint8_t data_bytes;                         // Parameter count, | ST7789_INIT_DELAY
+    uint8_t delay_ms;                           // Wait after the command (with ST7789_INIT_DELAY)
+    uint8_t data[ST7789_INIT_MAX_PARAMS];       // Parameters
+} st7789_init_cmd_t;
+
+/********************************************************************************
+ * Init Sequence (1.47" 172x320 panel, vendor settings)
+ ********************************************************************************/
+static const st7789_init_cmd_t st7789_init_table[] = {
+    /* Sleep Out */
+    {0x11, 0 | ST7789_INIT_DELAY, ST7789_SLPOUT_DELAY_MS, {0}},
+    /* RAM Control: little-endian RGB565 (ENDIAN bit), CPU-order buffers go out as is */
+    {0xB0, 2, 0, {0x00, 0xE8}},
+    /* Porch Setting */
+    {0xB2, 5, 0, {0x0C, 0x0C, 0x00, 0x33, 0x33}},
+    /* Gate Control */
+    {0xB7, 1, 0, {0x35}},
+    /* VCOM Setting */
+    {0xBB, 1, 0, {0x35}},
+    /* VDV and VRH Command Enable */
+    {0xC2, 1, 0, {0x01}},
+    /* VRH Set */
+    {0xC3, 1, 0, {0x13}},
+    /* VDV Set */
+    {0xC4, 1, 0, {0x20}},
+    /* Frame Rate Control, 60Hz */
+    {0xC6, 1, 0, {0x0F}},
+    /* Power Control 1 */
+    {0xD0, 2, 0, {0xA4, 0xA1}},
+    /* Power Control 2 */
+    {0xD6, 1, 0, {0xA1}},
+    /* Positive Voltage Gamma Control */
+    {0xE0, 14, 0, {0xF0, 0x00, 0x04, 0x04, 0x04, 0x05, 0x29, 0x33, 0x3E, 0x38, 0x12, 0x12, 0x28, 0x30}},
+    /* Negative Voltage Gamma Control */
+    {0xE1, 14, 0, {0xF0, 0x07, 0x0A, 0x0D, 0x0B, 0x07, 0x28, 0x33, 0x3E, 0x36, 0x14, 0x14, 0x29, 0x32}},
+    /* Display Inversion On */
+    {0x21, 0, 0, {0}},
+};
+
+#define ST7789_INIT_TABLE_SIZE      (sizeof(st7789_init_table) / sizeof(st7789_init_table[0]))
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,36 @@
+# Runs the boot test with the LCD initialized in the background and
+# inline, and fails unless the background build reaches the first frame
+# sooner. Both get the same peripheral setup time, which must be longer
+# than the LCD bring-up for the overlap to show.
+#
+#   cmake -DBACKGROUND=<test_boot_1> -DINLINE=<test_boot_0> -DSETUP_MS=150 -P boot_compare.cmake
+
+foreach(var BACKGROUND INLINE SETUP_MS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} is not set")
+    endif()
+endforeach()
+
+function(boot_time exe out_ms)
+    execute_process(COMMAND ${exe} ${SETUP_MS}
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+        RESULT_VARIABLE result)
+    message("${output}")
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${exe} exited with ${result}")
+    endif()
+    if(NOT output MATCHES "Boot to first frame: ([0-9]+) ms")
+        message(FATAL_ERROR "${exe} did not reach the first frame")
+    endif()
+    set(${out_ms} ${CMAKE_MATCH_1} PARENT_SCOPE)
+endfunction()
+
+boot_time(${BACKGROUND} background_ms)
+boot_time(${INLINE} inline_ms)
+
+message("Boot to first frame with ${SETUP_MS} ms peripheral setup: "
+        "${background_ms} ms in background, ${inline_ms} ms inline")
+if(NOT background_ms LESS inline_ms)
+    message(FATAL_ERROR "LCD init in background is not faster than inline")
+endif()
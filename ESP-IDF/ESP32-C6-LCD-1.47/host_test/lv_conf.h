@@ -0,0 +1,28 @@
+/*
+ * LVGL configuration for the host build
+ *
+ * Mirrors the device's sdkconfig (sdkconfig.defaults and the Kconfig
+ * defaults in main/Kconfig.projbuild); everything else keeps LVGL's
+ * defaults from lv_conf_internal.h, as it does through Kconfig.
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#include "sdkconfig.h"
+
+#define LV_COLOR_DEPTH              16
+#define LV_COLOR_16_SWAP            0
+
+#define LV_MEM_SIZE                 (48U * 1024U)
+
+#define LV_TICK_CUSTOM              CONFIG_LV_TICK_CUSTOM
+#define LV_TICK_CUSTOM_INCLUDE      "esp_timer.h"
+
+#define LV_USE_USER_DATA            1
+#define LV_USE_PERF_MONITOR         0
+
+#define LV_FONT_MONTSERRAT_12       1
+#define LV_FONT_MONTSERRAT_14       1
+#define LV_FONT_MONTSERRAT_16       1
+
+#endif /*LV_CONF_H*/
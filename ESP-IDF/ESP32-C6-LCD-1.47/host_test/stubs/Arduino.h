@@ -0,0 +1,34 @@
+/*
+ * Host stand-in for the Arduino-ESP32 core, for building the Arduino
+ * sketches' display driver: digitalWrite() ends in gpio_set_level() as on
+ * the device, so the bus monitor (host_spi.h) sees CS and D/C
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOW     0
+#define HIGH    1
+#define INPUT   0x01
+#define OUTPUT  0x03
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+unsigned long micros(void);
+unsigned long millis(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+
+#ifdef __cplusplus
+}
+#endif
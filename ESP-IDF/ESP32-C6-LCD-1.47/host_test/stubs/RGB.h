@@ -0,0 +1,9 @@
+/*
+ * Host stand-in for main/RGB/RGB.h: the calls made by app_main()
+ */
+#pragma once
+
+#include "esp_err.h"
+
+esp_err_t RGB_Init(void);
+void RGB_Example(void);
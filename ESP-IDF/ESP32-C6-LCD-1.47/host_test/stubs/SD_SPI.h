@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for main/SD_Card/SD_SPI.h: the sizes shown by the UI and
+ * the calls made by app_main()
+ */
+#pragma once
+
+#include <stdint.h>
+
+extern uint32_t SDCard_Size;
+extern uint32_t Flash_Size;
+
+#define SD_MOUNT_POINT     "/sdcard"
+
+void SD_Init(void);
+void Flash_Searching(void);
@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for main/Wireless/Wireless.h: the scan counts shown by the
+ * UI and the call made by app_main()
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+extern uint16_t BLE_NUM;
+extern uint16_t WIFI_NUM;
+extern bool Scan_finish;
+
+void Wireless_Init(void);
@@ -0,0 +1,50 @@
+/*
+ * Arduino-ESP32 core calls used by the sketches' display driver, on the host
+ */
+
+#include <unistd.h>
+#include "Arduino.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin; (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    gpio_set_level(pin, val);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)esp_timer_get_time();
+}
+
+unsigned long millis(void)
+{
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+void delay(uint32_t ms)
+{
+    usleep(ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    usleep(us);
+}
+
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution)
+{
+    (void)pin; (void)freq; (void)resolution;
+    return true;
+}
+
+bool ledcWrite(uint8_t pin, uint32_t duty)
+{
+    (void)pin; (void)duty;
+    return true;
+}
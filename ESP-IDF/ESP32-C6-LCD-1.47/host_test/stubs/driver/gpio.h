@@ -0,0 +1,24 @@
+/*
+ * Host stand-in for ESP-IDF's driver/gpio.h: calls succeed and do nothing
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_NC         (-1)
+#define GPIO_MODE_OUTPUT    2
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    int mode;
+    int pull_up_en;
+    int pull_down_en;
+    int intr_type;
+} gpio_config_t;
+
+esp_err_t gpio_config(const gpio_config_t *config);
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
@@ -0,0 +1,69 @@
+/*
+ * Host stand-in for ESP-IDF's driver/spi_master.h: there is no SPI bus,
+ * device transactions are counted by the bus monitor in host_spi.h
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SPI1_HOST,
+    SPI2_HOST,
+} spi_host_device_t;
+
+#define SPI_DMA_CH_AUTO 3
+
+#define SPI_DEVICE_HALFDUPLEX   (1 << 4)
+#define SPI_TRANS_USE_TXDATA    (1 << 3)
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+} spi_bus_config_t;
+
+typedef struct {
+    uint8_t mode;
+    int clock_speed_hz;
+    int spics_io_num;
+    uint32_t flags;
+    int queue_size;
+} spi_device_interface_config_t;
+
+typedef struct {
+    uint32_t flags;
+    size_t length;              // Total data length, in bits
+    void *user;
+    union {
+        const void *tx_buffer;
+        uint8_t tx_data[4];
+    };
+    void *rx_buffer;
+} spi_transaction_t;
+
+typedef struct host_spi_device *spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, int dma_chan);
+esp_err_t spi_bus_free(spi_host_device_t host_id);
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle);
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle);
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, TickType_t wait);
+void spi_device_release_bus(spi_device_handle_t device);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc);
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans_desc, TickType_t ticks_to_wait);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans_desc, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Host stand-in for ESP-IDF's esp_heap_caps.h: every capability is malloc()
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_DEFAULT      (1 << 12)
+
+#define HOST_HEAP_FREE_SIZE     (320 * 1024)   // Reported free heap, about what the C6 has after boot
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void heap_caps_free(void *ptr);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,6 @@
+/*
+ * Host stand-in for ESP-IDF's esp_lcd_panel_vendor.h
+ */
+#pragma once
+
+#include "esp_lcd_types.h"
@@ -0,0 +1,18 @@
+/*
+ * Host stand-in for ESP-IDF's esp_lcd_types.h
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+    LCD_RGB_ENDIAN_RGB,
+    LCD_RGB_ENDIAN_BGR,
+} lcd_color_rgb_endian_t;
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+typedef int esp_lcd_spi_bus_handle_t;
@@ -0,0 +1,619 @@
+/*
+ * ESP-IDF calls used by the LCD and LVGL code, on the host
+ *
+ * esp_timer runs its callbacks on one dispatcher thread, the way the
+ * esp_timer task does, and esp_timer_stop() reports ESP_ERR_INVALID_STATE
+ * once a one-shot timer has been taken for dispatch. That keeps the races
+ * between a callback and its owner the same as on the device.
+ */
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_interface.h"
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "driver/spi_master.h"
+#include "host_spi.h"
+#include "SD_SPI.h"
+#include "Wireless.h"
+
+// Values shown by the UI (SD_SPI.c / Wireless.c on the device)
+uint32_t SDCard_Size = 0;
+uint32_t Flash_Size = 4;
+uint16_t BLE_NUM = 0;
+uint16_t WIFI_NUM = 0;
+bool Scan_finish = false;
+
+// ---------------------------------------------------------------------------
+// esp_err / esp_log
+// ---------------------------------------------------------------------------
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    default:                    return "UNKNOWN ERROR";
+    }
+}
+
+void esp_error_check_failed(esp_err_t rc, const char *file, int line, const char *expression)
+{
+    fprintf(stderr, "ESP_ERROR_CHECK failed: %s at %s:%d: %s\n", esp_err_to_name(rc), file, line, expression);
+    abort();
+}
+
+static esp_log_level_t log_level = ESP_LOG_INFO;
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    // One level for every tag: only "*" is honoured
+    if (strcmp(tag, "*") == 0) {
+        log_level = level;
+    }
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if (level > log_level) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    pthread_mutex_lock(&log_lock);
+    printf("%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    vprintf(format, args);
+    putchar('\n');
+    pthread_mutex_unlock(&log_lock);
+    va_end(args);
+}
+
+// ---------------------------------------------------------------------------
+// esp_timer
+// ---------------------------------------------------------------------------
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t alarm_us;           // 0 = not armed
+    uint64_t period_us;         // 0 = one-shot
+    struct esp_timer *next;
+};
+
+static pthread_mutex_t timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timer_cond;
+static pthread_cond_t timer_idle_cond;
+static struct esp_timer *timer_list;
+static struct esp_timer *timer_running;
+static pthread_t timer_thread;
+static pthread_once_t timer_once = PTHREAD_ONCE_INIT;
+static struct timespec time_base;
+static uint32_t dispatch_latency_us;
+
+static void timer_set_time_base(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &time_base);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    static pthread_once_t base_once = PTHREAD_ONCE_INIT;
+    pthread_once(&base_once, timer_set_time_base);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)(now.tv_sec - time_base.tv_sec) * 1000000 + (now.tv_nsec - time_base.tv_nsec) / 1000;
+}
+
+static void *timer_task(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&timer_lock);
+    for (;;) {
+        // Earliest armed timer
+        struct esp_timer *due = NULL;
+        for (struct esp_timer *t = timer_list; t != NULL; t = t->next) {
+            if (t->alarm_us != 0 && (due == NULL || t->alarm_us < due->alarm_us)) {
+                due = t;
+            }
+        }
+        if (due == NULL) {
+            pthread_cond_wait(&timer_cond, &timer_lock);
+            continue;
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (due->alarm_us > now) {
+            int64_t at = due->alarm_us;
+            struct timespec ts = {
+                .tv_sec = time_base.tv_sec + at / 1000000,
+                .tv_nsec = time_base.tv_nsec + (at % 1000000) * 1000,
+            };
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&timer_cond, &timer_lock, &ts);
+            continue;
+        }
+
+        // One-shot timers are disarmed before the callback, so a stop from
+        // here on fails like it does on the device
+        if (due->period_us != 0) {
+            due->alarm_us += due->period_us;
+            if (due->alarm_us <= now) {
+                due->alarm_us = now + due->period_us;     // skip_unhandled_events
+            }
+        } else {
+            due->alarm_us = 0;
+        }
+        timer_running = due;
+        pthread_mutex_unlock(&timer_lock);
+        uint32_t latency_us = __atomic_load_n(&dispatch_latency_us, __ATOMIC_RELAXED);
+        if (latency_us != 0) {
+            esp_rom_delay_us(latency_us);
+        }
+        due->callback(due->arg);
+        pthread_mutex_lock(&timer_lock);
+        timer_running = NULL;
+        pthread_cond_broadcast(&timer_idle_cond);
+    }
+    return NULL;
+}
+
+static void timer_start_task(void)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&timer_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_cond_init(&timer_idle_cond, NULL);
+    esp_timer_get_time();
+    pthread_create(&timer_thread, NULL, timer_task, NULL);
+    pthread_detach(timer_thread);
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_once(&timer_once, timer_start_task);
+
+    struct esp_timer *timer = calloc(1, sizeof(struct esp_timer));
+    if (timer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+
+    pthread_mutex_lock(&timer_lock);
+    timer->next = timer_list;
+    timer_list = timer;
+    pthread_mutex_unlock(&timer_lock);
+
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t timer_arm(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = ESP_OK;
+    pthread_mutex_lock(&timer_lock);
+    if (timer->alarm_us != 0) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        // 0 means disarmed, so a timeout of 0 fires 1 us late
+        timer->alarm_us = esp_timer_get_time() + (timeout_us ? timeout_us : 1);
+        timer->period_us = period_us;
+        pthread_cond_signal(&timer_cond);
+    }
+    pthread_mutex_unlock(&timer_lock);
+    return ret;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return timer_arm(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return timer_arm(timer, period, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = ESP_OK;
+    pthread_mutex_lock(&timer_lock);
+    if (timer->alarm_us == 0) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        timer->alarm_us = 0;
+    }
+    pthread_mutex_unlock(&timer_lock);
+    return ret;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timer_lock);
+    if (timer->alarm_us != 0) {
+        pthread_mutex_unlock(&timer_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    while (timer_running == timer && !pthread_equal(pthread_self(), timer_thread)) {
+        pthread_cond_wait(&timer_idle_cond, &timer_lock);
+    }
+    for (struct esp_timer **link = &timer_list; *link != NULL; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&timer_lock);
+    free(timer);
+    return ESP_OK;
+}
+
+void esp_timer_host_set_dispatch_latency(uint32_t latency_us)
+{
+    __atomic_store_n(&dispatch_latency_us, latency_us, __ATOMIC_RELAXED);
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    pthread_mutex_lock(&timer_lock);
+    bool active = timer->alarm_us != 0;
+    pthread_mutex_unlock(&timer_lock);
+    return active;
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    usleep(us);
+}
+
+// ---------------------------------------------------------------------------
+// Heap
+// ---------------------------------------------------------------------------
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    (void)caps;
+    return calloc(n, size);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    (void)caps;
+    return HOST_HEAP_FREE_SIZE;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    (void)caps;
+    return HOST_HEAP_FREE_SIZE;
+}
+
+// ---------------------------------------------------------------------------
+// esp_lcd: panel calls go through the panel's function table, there is no IO
+// ---------------------------------------------------------------------------
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t *io_config, esp_lcd_panel_io_handle_t *ret_io)
+{
+    (void)bus;
+    (void)io_config;
+    (void)ret_io;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    (void)io;
+    (void)lcd_cmd;
+    (void)param;
+    (void)param_size;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *color, size_t color_size)
+{
+    (void)io;
+    (void)lcd_cmd;
+    (void)color;
+    (void)color_size;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    return io == NULL ? ESP_ERR_INVALID_ARG : ESP_ERR_NOT_SUPPORTED;
+}
+
+#define PANEL_CALL(panel, op, ...) do {                             \
+        if ((panel) == NULL) return ESP_ERR_INVALID_ARG;            \
+        if ((panel)->op == NULL) return ESP_ERR_NOT_SUPPORTED;      \
+        return (panel)->op((panel), ##__VA_ARGS__);                 \
+    } while (0)
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel)
+{
+    PANEL_CALL(panel, reset);
+}
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel)
+{
+    PANEL_CALL(panel, init);
+}
+
+esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel)
+{
+    PANEL_CALL(panel, del);
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    if (x_start >= x_end || y_start >= y_end) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    PANEL_CALL(panel, draw_bitmap, x_start, y_start, x_end, y_end, color_data);
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x, bool mirror_y)
+{
+    PANEL_CALL(panel, mirror, mirror_x, mirror_y);
+}
+
+esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes)
+{
+    PANEL_CALL(panel, swap_xy, swap_axes);
+}
+
+esp_err_t esp_lcd_panel_set_gap(esp_lcd_panel_handle_t panel, int x_gap, int y_gap)
+{
+    PANEL_CALL(panel, set_gap, x_gap, y_gap);
+}
+
+esp_err_t esp_lcd_panel_invert_color(esp_lcd_panel_handle_t panel, bool invert_color_data)
+{
+    PANEL_CALL(panel, invert_color, invert_color_data);
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off)
+{
+    PANEL_CALL(panel, disp_on_off, on_off);
+}
+
+// ---------------------------------------------------------------------------
+// LEDC: accepted and ignored
+// ---------------------------------------------------------------------------
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf) { (void)timer_conf; return ESP_OK; }
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf) { (void)ledc_conf; return ESP_OK; }
+esp_err_t ledc_fade_func_install(int intr_alloc_flags) { (void)intr_alloc_flags; return ESP_OK; }
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty) { (void)speed_mode; (void)channel; (void)duty; return ESP_OK; }
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel) { (void)speed_mode; (void)channel; return ESP_OK; }
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty, int max_fade_time_ms)
+{
+    (void)speed_mode; (void)channel; (void)target_duty; (void)max_fade_time_ms;
+    return ESP_OK;
+}
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_fade_mode_t fade_mode)
+{
+    (void)speed_mode; (void)channel; (void)fade_mode;
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------------------
+// GPIO and SPI: levels of the monitored pins and the bytes a device sends
+// are counted (host_spi.h), nothing else happens
+// ---------------------------------------------------------------------------
+
+static pthread_mutex_t bus_lock = PTHREAD_MUTEX_INITIALIZER;           // Guards the monitor
+static pthread_mutex_t bus_acquire_lock = PTHREAD_MUTEX_INITIALIZER;   // spi_device_acquire_bus()
+static host_spi_stats_t bus_stats;
+static int bus_cs_pin = -1;
+static int bus_dc_pin = -1;
+static uint32_t bus_cs_level = 1;
+static uint32_t bus_dc_level = 1;
+
+#define HOST_SPI_DEVICE_QUEUE   8
+
+struct host_spi_device {
+    spi_transaction_t *done[HOST_SPI_DEVICE_QUEUE];    // Sent, result not fetched yet
+    int done_count;
+    int queue_size;
+};
+
+void host_spi_monitor(int cs_pin, int dc_pin)
+{
+    pthread_mutex_lock(&bus_lock);
+    bus_cs_pin = cs_pin;
+    bus_dc_pin = dc_pin;
+    bus_cs_level = 1;
+    bus_dc_level = 1;
+    memset(&bus_stats, 0, sizeof(bus_stats));
+    pthread_mutex_unlock(&bus_lock);
+}
+
+void host_spi_reset_stats(void)
+{
+    pthread_mutex_lock(&bus_lock);
+    memset(&bus_stats, 0, sizeof(bus_stats));
+    pthread_mutex_unlock(&bus_lock);
+}
+
+void host_spi_get_stats(host_spi_stats_t *stats)
+{
+    pthread_mutex_lock(&bus_lock);
+    *stats = bus_stats;
+    pthread_mutex_unlock(&bus_lock);
+}
+
+static void bus_count(const spi_transaction_t *trans)
+{
+    uint32_t bytes = (uint32_t)(trans->length / 8);
+
+    pthread_mutex_lock(&bus_lock);
+    bus_stats.transfers++;
+    bus_stats.bytes += bytes;
+    if (bus_dc_level == 0) {
+        const uint8_t *data = (trans->flags & SPI_TRANS_USE_TXDATA) ? trans->tx_data
+                                                                    : (const uint8_t *)trans->tx_buffer;
+        for (uint32_t i = 0; i < bytes; i++) {
+            if (bus_stats.command_bytes < HOST_SPI_COMMAND_LOG) {
+                bus_stats.commands[bus_stats.command_bytes] = data[i];
+            }
+            bus_stats.command_bytes++;
+        }
+    }
+    pthread_mutex_unlock(&bus_lock);
+}
+
+esp_err_t gpio_config(const gpio_config_t *config) { (void)config; return ESP_OK; }
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) { (void)gpio_num; return ESP_OK; }
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    level = level ? 1 : 0;
+    pthread_mutex_lock(&bus_lock);
+    if (gpio_num == bus_cs_pin) {
+        if (bus_cs_level == 1 && level == 0) {
+            bus_stats.cs_frames++;
+        }
+        bus_cs_level = level;
+    }
+    if (gpio_num == bus_dc_pin) {
+        bus_dc_level = level;
+    }
+    pthread_mutex_unlock(&bus_lock);
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, int dma_chan)
+{
+    (void)host_id; (void)bus_config; (void)dma_chan;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host_id)
+{
+    (void)host_id;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle)
+{
+    (void)host_id;
+    if (dev_config->queue_size <= 0 || dev_config->queue_size > HOST_SPI_DEVICE_QUEUE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    spi_device_handle_t device = calloc(1, sizeof(struct host_spi_device));
+    if (device == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    device->queue_size = dev_config->queue_size;
+    *handle = device;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    if (handle->done_count > 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, TickType_t wait)
+{
+    (void)device; (void)wait;
+    pthread_mutex_lock(&bus_acquire_lock);
+    return ESP_OK;
+}
+
+void spi_device_release_bus(spi_device_handle_t device)
+{
+    (void)device;
+    pthread_mutex_unlock(&bus_acquire_lock);
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc)
+{
+    if (handle->done_count > 0) {
+        // The device driver refuses polling while queued transactions are pending
+        return ESP_ERR_INVALID_STATE;
+    }
+    bus_count(trans_desc);
+    return ESP_OK;
+}
+
+// Queued transactions complete at once; the result waits for get_trans_result()
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans_desc, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (handle->done_count == handle->queue_size) {
+        return ESP_ERR_TIMEOUT;
+    }
+    bus_count(trans_desc);
+    handle->done[handle->done_count++] = trans_desc;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans_desc, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (handle->done_count == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *trans_desc = handle->done[0];
+    handle->done_count--;
+    memmove(&handle->done[0], &handle->done[1], handle->done_count * sizeof(handle->done[0]));
+    return ESP_OK;
+}
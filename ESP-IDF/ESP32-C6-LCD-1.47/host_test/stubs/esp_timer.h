@@ -0,0 +1,42 @@
+/*
+ * Host stand-in for ESP-IDF's esp_timer.h
+ *
+ * Timers run on one dispatcher thread, like the esp_timer task. Time is
+ * CLOCK_MONOTONIC since the first call, so it starts near 0 like on the
+ * device.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct esp_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum {
+    ESP_TIMER_TASK,
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char *name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+bool esp_timer_is_active(esp_timer_handle_t timer);
+int64_t esp_timer_get_time(void);
+
+/**
+ * Host only: delay between a timer expiring (esp_timer_stop() fails from
+ * then on) and its callback running, like a busy esp_timer task or ISR
+ * latency on the device. 0 by default.
+ */
+void esp_timer_host_set_dispatch_latency(uint32_t latency_us);
@@ -0,0 +1,43 @@
+/*
+ * Host stand-in for FreeRTOS on POSIX threads
+ *
+ * Tasks are threads and run truly in parallel; priorities and core
+ * affinity are ignored. Only the calls used by the LCD and LVGL code are
+ * provided. The tick rate is the ESP-IDF default, so delays and timeouts
+ * round the way they do on the device.
+ */
+#pragma once
+
+#include <assert.h>     // Included by FreeRTOSConfig.h on ESP-IDF
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+typedef struct host_task *TaskHandle_t;
+typedef struct host_sem *SemaphoreHandle_t;
+typedef struct host_queue *QueueHandle_t;
+typedef struct host_event_group *EventGroupHandle_t;
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t EventBits_t;
+typedef uint8_t StackType_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define tskNO_AFFINITY      0x7fffffff
+
+#define configTICK_RATE_HZ  CONFIG_FREERTOS_HZ
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+#define portYIELD_FROM_ISR(woken)   (void)(woken)
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portENTER_CRITICAL(mux)         (void)(mux)
+#define portEXIT_CRITICAL(mux)          (void)(mux)
@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for FreeRTOS event_groups.h, see FreeRTOS.h
+ */
+#pragma once
+
+#include "FreeRTOS.h"
+
+EventGroupHandle_t xEventGroupCreate(void);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait);
+void vEventGroupDelete(EventGroupHandle_t group);
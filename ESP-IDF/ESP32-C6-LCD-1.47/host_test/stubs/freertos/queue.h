@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for FreeRTOS queue.h, see FreeRTOS.h
+ */
+#pragma once
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks_to_wait);
+void vQueueDelete(QueueHandle_t queue);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,508 @@
+/*
+ * FreeRTOS calls used by the LCD and LVGL code, on POSIX threads
+ *
+ * Every task is a detached pthread with its own notification value. A
+ * thread that was not created by xTaskCreate() (main, the esp_timer
+ * dispatcher) gets a task object the first time it needs one, so it can
+ * receive notifications like the app_main task does.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+
+struct host_task {
+    TaskFunction_t fn;
+    void *arg;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify_value;
+};
+
+typedef enum {
+    HOST_SEM_COUNTING,
+    HOST_SEM_MUTEX,
+    HOST_SEM_RECURSIVE,
+} host_sem_type_t;
+
+struct host_sem {
+    host_sem_type_t type;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    UBaseType_t count;
+    UBaseType_t max_count;
+    TaskHandle_t owner;         // Mutexes only
+    UBaseType_t depth;          // Recursive mutex only
+};
+
+struct host_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;        // Signalled on every send and receive
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t count;
+    UBaseType_t head;
+    uint8_t *items;
+};
+
+struct host_event_group {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    EventBits_t bits;
+};
+
+static __thread TaskHandle_t current_task;
+
+// ---------------------------------------------------------------------------
+// Time
+// ---------------------------------------------------------------------------
+
+static void cond_init_monotonic(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static struct timespec deadline_after(TickType_t ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000ULL + ts.tv_nsec;
+    ts.tv_sec += ns / 1000000000ULL;
+    ts.tv_nsec = ns % 1000000000ULL;
+    return ts;
+}
+
+/**
+ * Wait on cond until woken or the deadline passes
+ * @return false on timeout
+ */
+static bool cond_wait_ticks(pthread_cond_t *cond, pthread_mutex_t *lock, TickType_t ticks,
+                            const struct timespec *deadline)
+{
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ms = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    return (TickType_t)(ms / portTICK_PERIOD_MS);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec ts = {
+        .tv_sec = (ticks * portTICK_PERIOD_MS) / 1000,
+        .tv_nsec = ((ticks * portTICK_PERIOD_MS) % 1000) * 1000000L,
+    };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tasks and notifications
+// ---------------------------------------------------------------------------
+
+static TaskHandle_t task_alloc(TaskFunction_t fn, void *arg)
+{
+    TaskHandle_t task = calloc(1, sizeof(struct host_task));
+    if (task == NULL) {
+        return NULL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    pthread_mutex_init(&task->lock, NULL);
+    cond_init_monotonic(&task->cond);
+    return task;
+}
+
+static void *task_entry(void *param)
+{
+    current_task = param;
+    current_task->fn(current_task->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    (void)core_id;
+
+    TaskHandle_t task = task_alloc(fn, arg);
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    if (created_task != NULL) {
+        *created_task = task;
+    }
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int rc = pthread_create(&thread, &attr, task_entry, task);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created_task)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, created_task, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    // Only self-deletion is used. The handle is kept: another thread may
+    // still be notifying it.
+    if (task == NULL || task == current_task) {
+        pthread_exit(NULL);
+    }
+    abort();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    if (current_task == NULL) {
+        current_task = task_alloc(NULL, NULL);
+    }
+    return current_task;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    struct timespec deadline = deadline_after(ticks_to_wait);
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify_value == 0 && ticks_to_wait != 0) {
+        if (!cond_wait_ticks(&task->cond, &task->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    uint32_t value = task->notify_value;
+    if (value != 0) {
+        task->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify_value++;
+    pthread_cond_signal(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    xTaskNotifyGive(task);
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Semaphores and mutexes
+// ---------------------------------------------------------------------------
+
+static SemaphoreHandle_t sem_create(host_sem_type_t type, UBaseType_t max_count, UBaseType_t initial_count)
+{
+    SemaphoreHandle_t sem = calloc(1, sizeof(struct host_sem));
+    if (sem == NULL) {
+        return NULL;
+    }
+    sem->type = type;
+    sem->count = initial_count;
+    sem->max_count = max_count;
+    pthread_mutex_init(&sem->lock, NULL);
+    cond_init_monotonic(&sem->cond);
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return sem_create(HOST_SEM_COUNTING, 1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    return sem_create(HOST_SEM_COUNTING, max_count, initial_count);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return sem_create(HOST_SEM_MUTEX, 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return sem_create(HOST_SEM_RECURSIVE, 1, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    struct timespec deadline = deadline_after(ticks_to_wait);
+    BaseType_t taken = pdFALSE;
+
+    pthread_mutex_lock(&sem->lock);
+    while (sem->count == 0 && ticks_to_wait != 0) {
+        if (!cond_wait_ticks(&sem->cond, &sem->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    if (sem->count > 0) {
+        sem->count--;
+        if (sem->type != HOST_SEM_COUNTING) {
+            sem->owner = xTaskGetCurrentTaskHandle();
+        }
+        taken = pdTRUE;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return taken;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    BaseType_t given = pdFALSE;
+
+    pthread_mutex_lock(&sem->lock);
+    if (sem->count < sem->max_count) {
+        sem->count++;
+        sem->owner = NULL;
+        pthread_cond_signal(&sem->cond);
+        given = pdTRUE;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return given;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_priority_task_woken)
+{
+    BaseType_t given = xSemaphoreGive(sem);
+    if (given && higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+    return given;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticks_to_wait)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    pthread_mutex_lock(&mutex->lock);
+    if (mutex->owner == self) {
+        mutex->depth++;
+        pthread_mutex_unlock(&mutex->lock);
+        return pdTRUE;
+    }
+    pthread_mutex_unlock(&mutex->lock);
+
+    if (!xSemaphoreTake(mutex, ticks_to_wait)) {
+        return pdFALSE;
+    }
+    mutex->depth = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex)
+{
+    pthread_mutex_lock(&mutex->lock);
+    if (mutex->owner != xTaskGetCurrentTaskHandle()) {
+        pthread_mutex_unlock(&mutex->lock);
+        return pdFALSE;
+    }
+    bool release = --mutex->depth == 0;
+    pthread_mutex_unlock(&mutex->lock);
+
+    return release ? xSemaphoreGive(mutex) : pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    if (sem == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->lock);
+    free(sem);
+}
+
+// ---------------------------------------------------------------------------
+// Queues
+// ---------------------------------------------------------------------------
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = calloc(1, sizeof(struct host_queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->items = malloc((size_t)length * item_size);
+    if (queue->items == NULL) {
+        free(queue);
+        return NULL;
+    }
+    queue->length = length;
+    queue->item_size = item_size;
+    pthread_mutex_init(&queue->lock, NULL);
+    cond_init_monotonic(&queue->cond);
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    struct timespec deadline = deadline_after(ticks_to_wait);
+    BaseType_t sent = pdFALSE;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length && ticks_to_wait != 0) {
+        if (!cond_wait_ticks(&queue->cond, &queue->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    if (queue->count < queue->length) {
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(queue->items + (size_t)tail * queue->item_size, item, queue->item_size);
+        queue->count++;
+        pthread_cond_broadcast(&queue->cond);
+        sent = pdTRUE;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return sent;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks_to_wait)
+{
+    struct timespec deadline = deadline_after(ticks_to_wait);
+    BaseType_t received = pdFALSE;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && ticks_to_wait != 0) {
+        if (!cond_wait_ticks(&queue->cond, &queue->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    if (queue->count > 0) {
+        memcpy(buffer, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->cond);
+        received = pdTRUE;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return received;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (queue == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&queue->cond);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue->items);
+    free(queue);
+}
+
+// ---------------------------------------------------------------------------
+// Event groups
+// ---------------------------------------------------------------------------
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    EventGroupHandle_t group = calloc(1, sizeof(struct host_event_group));
+    if (group == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&group->lock, NULL);
+    cond_init_monotonic(&group->cond);
+    return group;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    group->bits |= bits;
+    EventBits_t value = group->bits;
+    pthread_cond_broadcast(&group->cond);
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+    struct timespec deadline = deadline_after(ticks_to_wait);
+
+    pthread_mutex_lock(&group->lock);
+    for (;;) {
+        EventBits_t set = group->bits & bits;
+        if (wait_for_all ? set == bits : set != 0) {
+            break;
+        }
+        if (ticks_to_wait == 0 || !cond_wait_ticks(&group->cond, &group->lock, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    EventBits_t value = group->bits;
+    bool satisfied = wait_for_all ? (value & bits) == bits : (value & bits) != 0;
+    if (satisfied && clear_on_exit) {
+        group->bits &= ~bits;
+    }
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group)
+{
+    if (group == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&group->cond);
+    pthread_mutex_destroy(&group->lock);
+    free(group);
+}
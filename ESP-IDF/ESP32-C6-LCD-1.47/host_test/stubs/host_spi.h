@@ -0,0 +1,35 @@
+/*
+ * Bus monitor for the spi_master and GPIO stand-ins
+ *
+ * There is no SPI peripheral on the host. spi_device_* calls only count
+ * what would have been clocked out, and gpio_set_level() (which Arduino's
+ * digitalWrite() also ends in) tracks the chip select and D/C pins, so a
+ * test can check how many CS-framed transactions and bytes a driver call
+ * costs.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOST_SPI_COMMAND_LOG    32      // Command bytes kept in host_spi_stats_t
+
+typedef struct {
+    uint32_t cs_frames;         // CS falling edges on the monitored pin
+    uint32_t transfers;         // spi_transaction_t handed to a device
+    uint32_t bytes;             // Bytes clocked out, commands included
+    uint32_t command_bytes;     // Bytes clocked out while D/C was low
+    uint8_t commands[HOST_SPI_COMMAND_LOG]; // First command bytes, in order
+} host_spi_stats_t;
+
+// Select the CS and D/C pins to watch and clear the counters
+void host_spi_monitor(int cs_pin, int dc_pin);
+void host_spi_reset_stats(void);
+void host_spi_get_stats(host_spi_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
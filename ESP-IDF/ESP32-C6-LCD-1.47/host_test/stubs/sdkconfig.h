@@ -0,0 +1,11 @@
+/*
+ * Host build configuration: the virtual panel in realtime mode, with the
+ * flush metrics, LVGL tickless (CONFIG_LV_TICK_CUSTOM is set on the
+ * compiler command line so CMake can build both tick variants)
+ */
+#pragma once
+
+#define CONFIG_LCD_VIRTUAL_PANEL            1
+#define CONFIG_LCD_VIRTUAL_PANEL_REALTIME   1
+#define CONFIG_LVGL_DRIVER_METRICS          1
+#define CONFIG_FREERTOS_HZ                  100
@@ -0,0 +1,49 @@
+/*
+ * Host test: app_main() from boot to the first frame
+ *
+ * Built twice, with the LCD initialized in the background
+ * (CONFIG_LCD_INIT_IN_BACKGROUND=1) and inline (0), on the realtime
+ * virtual panel, which waits out the reset recovery and sleep-out delays
+ * like the ST7789. app_main() logs "Boot to first frame"; boot_compare.cmake
+ * runs both builds and checks that the background one gets there first.
+ *
+ * Wireless, RGB LED and SD card setup are stand-ins below. They take the
+ * time given as the first argument (ms, split evenly, default 0), so the
+ * overlap can be tried with the peripheral setup time of a board.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "RGB.h"
+#include "SD_SPI.h"
+#include "Wireless.h"
+
+void app_main(void);
+
+static uint32_t peripheral_setup_ms = 0;
+
+static void peripheral_setup(void)
+{
+    if (peripheral_setup_ms > 0) {
+        vTaskDelay(pdMS_TO_TICKS(peripheral_setup_ms / 3));
+    }
+}
+
+void Wireless_Init(void) { peripheral_setup(); }
+void Flash_Searching(void) {}
+esp_err_t RGB_Init(void) { peripheral_setup(); return ESP_OK; }
+void RGB_Example(void) {}
+void SD_Init(void) { peripheral_setup(); }
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        peripheral_setup_ms = (uint32_t)atoi(argv[1]);
+    }
+    esp_timer_get_time();   // Time since boot starts here
+    app_main();
+    return EXIT_SUCCESS;
+}
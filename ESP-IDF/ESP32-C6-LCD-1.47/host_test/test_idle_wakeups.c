@@ -0,0 +1,81 @@
+/*
+ * Host test: wakeups while the demo UI sits idle
+ *
+ * Built twice, tickless (CONFIG_LV_TICK_CUSTOM=1) and with the periodic
+ * tick timer (0). After boot and the first frame the metrics are reset,
+ * the UI runs on its own for IDLE_MS, then the render task passes and tick
+ * timer callbacks are read back from the metrics. Render task wakeups
+ * follow LVGL's own timers (display refresh, the UI's 100 ms update), so
+ * the bound only catches a render task that no longer sleeps.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ST7789.h"
+#include "LVGL_Driver.h"
+#include "LVGL_Example.h"
+
+#define IDLE_MS                 3000
+#define TASK_WAKEUPS_MAX_PER_S  (1000 / LV_DISP_DEF_REFR_PERIOD + 1000 / 100 + 1)
+
+int main(void)
+{
+    int failures = 0;
+
+    st7789_config_t lcd_config = st7789_get_default_config();
+    st7789_device_t *lcd = st7789_create(&lcd_config);
+    if (lcd == NULL || st7789_init(lcd) != ESP_OK) {
+        printf("FAIL: LCD init\n");
+        return EXIT_FAILURE;
+    }
+    lvgl_config_t lvgl_config = lvgl_get_default_config(lcd);
+    lvgl_driver_t *lvgl = lvgl_driver_create(&lvgl_config);
+    if (lvgl == NULL || lvgl_driver_init(lvgl) != ESP_OK) {
+        printf("FAIL: LVGL init\n");
+        return EXIT_FAILURE;
+    }
+    if (lvgl_driver_lock(lvgl, -1)) {
+        Lvgl_Example1();
+        lv_refr_now(NULL);
+        lvgl_driver_unlock(lvgl);
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(500));
+    lvgl_driver_reset_metrics(lvgl);
+    vTaskDelay(pdMS_TO_TICKS(IDLE_MS));
+    lvgl_driver_dump_metrics(lvgl);
+
+    lvgl_metrics_t m;
+    if (lvgl_driver_get_metrics(lvgl, &m) != ESP_OK) {
+        printf("FAIL: no metrics\n");
+        return EXIT_FAILURE;
+    }
+    double seconds = m.elapsed_us / 1e6;
+    double task_rate = m.task_wakeups / seconds;
+    double tick_rate = m.tick_wakeups / seconds;
+    printf("CONFIG_LV_TICK_CUSTOM=%d: render task %.1f/s, tick timer %.1f/s, %lu frames in %.2f s\n",
+           CONFIG_LV_TICK_CUSTOM, task_rate, tick_rate, (unsigned long)m.frames, seconds);
+
+    if (task_rate > TASK_WAKEUPS_MAX_PER_S) {
+        printf("FAIL: render task wakes %.1f/s, expected at most %d/s\n", task_rate, TASK_WAKEUPS_MAX_PER_S);
+        failures++;
+    }
+#if CONFIG_LV_TICK_CUSTOM
+    if (m.tick_wakeups != 0) {
+        printf("FAIL: %lu tick timer callbacks without a tick timer\n", (unsigned long)m.tick_wakeups);
+        failures++;
+    }
+#else
+    // One callback every tick_period_ms, allow for host scheduling jitter
+    double expected = 1000.0 / lvgl_config.tick_period_ms;
+    if (tick_rate < expected * 0.8 || tick_rate > expected * 1.05) {
+        printf("FAIL: tick timer %.1f/s, expected %.0f/s\n", tick_rate, expected);
+        failures++;
+    }
+#endif
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/*
+ * Host test: SPI transactions and bytes per drawPixelBuffer() of the
+ * Arduino sketches' ST7789 driver
+ *
+ * The driver is built from Arduino/examples/LVGL_Arduino against the
+ * Arduino core and spi_master stand-ins in stubs/. The bus monitor counts
+ * CS-framed transactions and bytes. "Before" replays the unbatched window
+ * setup the driver used to do (one transaction per command and parameter
+ * byte, then one for the pixels) through its single write methods;
+ * "after" is drawPixelBuffer() itself, blocking and through the
+ * transfer task.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_spi.h"
+#include "Display_ST7789.h"
+
+#define AREA_X1     10
+#define AREA_Y1     20
+#define AREA_X2     (AREA_X1 + 99)
+#define AREA_Y2     (AREA_Y1 + 9)
+#define AREA_PIXELS ((AREA_X2 - AREA_X1 + 1) * (AREA_Y2 - AREA_Y1 + 1))
+
+#define WINDOW_BYTES    (2 * ST7789_WINDOW_CMD_BYTES + 1)  // CASET, RASET, RAMWR
+#define PIXEL_BYTES     (AREA_PIXELS * 2)
+
+/**
+ * ST7789Display with the window setup as it was before batching
+ */
+class UnbatchedDisplay : public ST7789Display {
+public:
+    void drawPixelBuffer(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t* buffer) {
+        const ST7789Config cfg = ST7789Config::getDefault();
+        writeCommand(0x2A);
+        writeData(x1 >> 8);
+        writeData(x1 + cfg.offset_x);
+        writeData(x2 >> 8);
+        writeData(x2 + cfg.offset_x);
+        writeCommand(0x2B);
+        writeData(y1 >> 8);
+        writeData(y1 + cfg.offset_y);
+        writeData(y2 >> 8);
+        writeData(y2 + cfg.offset_y);
+        writeCommand(0x2C);
+        writeDataBytes((uint8_t*)buffer, PIXEL_BYTES);
+    }
+};
+
+static uint16_t pixels[AREA_PIXELS];
+
+static int check(const char *label, uint32_t value, uint32_t expected)
+{
+    if (value != expected) {
+        printf("FAIL: %s: %lu, expected %lu\n", label, (unsigned long)value, (unsigned long)expected);
+        return 1;
+    }
+    return 0;
+}
+
+static void report(const char *label, const host_spi_stats_t *s)
+{
+    printf("%-26s %2lu transactions, %5lu bytes (%lu command bytes)\n", label,
+           (unsigned long)s->cs_frames, (unsigned long)s->bytes, (unsigned long)s->command_bytes);
+}
+
+int main(void)
+{
+    int failures = 0;
+    host_spi_stats_t s;
+
+    // Heap allocated and never deleted: the transfer task cannot be
+    // stopped on the host (vTaskDelete of another task aborts)
+    UnbatchedDisplay *display = new UnbatchedDisplay();
+    host_spi_monitor(EXAMPLE_PIN_NUM_LCD_CS, EXAMPLE_PIN_NUM_LCD_DC);
+    if (!display->begin()) {
+        printf("FAIL: display begin\n");
+        return EXIT_FAILURE;
+    }
+
+    // Before: 11 transactions for the window, one for the pixels
+    host_spi_reset_stats();
+    display->drawPixelBuffer(AREA_X1, AREA_Y1, AREA_X2, AREA_Y2, pixels);
+    host_spi_get_stats(&s);
+    report("before batching:", &s);
+    uint32_t before_frames = s.cs_frames;
+    failures += check("unbatched transactions", s.cs_frames, 12);
+    failures += check("unbatched bytes", s.bytes, WINDOW_BYTES + PIXEL_BYTES);
+
+    // After: window and pixels in one transaction
+    ST7789Display &batched = *display;
+    batched.invalidateWindow();
+    batched.resetBusStats();
+    host_spi_reset_stats();
+    batched.drawPixelBuffer(AREA_X1, AREA_Y1, AREA_X2, AREA_Y2, pixels);
+    host_spi_get_stats(&s);
+    report("after batching:", &s);
+    failures += check("batched transactions", s.cs_frames, 1);
+    failures += check("batched bytes", s.bytes, WINDOW_BYTES + PIXEL_BYTES);
+    failures += check("batched command bytes", s.command_bytes, 3);
+    static const uint8_t window_cmds[] = { 0x2A, 0x2B, 0x2C };
+    for (unsigned i = 0; i < sizeof(window_cmds); i++) {
+        failures += check("batched command", s.commands[i], window_cmds[i]);
+    }
+    ST7789Display::BusStats stats = batched.getBusStats();
+    failures += check("driver transaction count", stats.transactions, s.cs_frames);
+    failures += check("driver byte count", stats.bytes, s.bytes);
+
+    // Same area again: the window cache leaves only RAMWR
+    host_spi_reset_stats();
+    batched.drawPixelBuffer(AREA_X1, AREA_Y1, AREA_X2, AREA_Y2, pixels);
+    host_spi_get_stats(&s);
+    report("after, same window:", &s);
+    failures += check("cached transactions", s.cs_frames, 1);
+    failures += check("cached bytes", s.bytes, 1 + PIXEL_BYTES);
+
+    // Through the transfer task: one transaction, pixels queued in chunks
+    if (!batched.beginAsync()) {
+        printf("FAIL: beginAsync\n");
+        return EXIT_FAILURE;
+    }
+    batched.invalidateWindow();
+    host_spi_reset_stats();
+    batched.drawPixelBufferAsync(AREA_X1, AREA_Y1, AREA_X2, AREA_Y2, pixels);
+    batched.waitForTransfers();
+    host_spi_get_stats(&s);
+    report("after batching, async:", &s);
+    failures += check("async transactions", s.cs_frames, 1);
+    failures += check("async bytes", s.bytes, WINDOW_BYTES + PIXEL_BYTES);
+
+    printf("%lu transactions per drawPixelBuffer before batching, %lu after\n",
+           (unsigned long)before_frames, (unsigned long)s.cs_frames);
+    if (failures > 0) {
+        printf("%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,413 @@
+/*
+ * Host test: render through the virtual panel
+ *
+ * 1. Raw panel: a known band pattern, checked against the bus model
+ *    (3 transactions and 11 command bytes per draw at 12 MHz) and against
+ *    the PPM the panel writes.
+ * 2. Back to back: draws that do not wait for the previous transfer, each
+ *    must still report done exactly once.
+ * 3. Full stack: ST7789 driver (virtual panel) + LVGL driver + the demo UI,
+ *    one frame rendered with lv_refr_now() like app_main does, then the
+ *    modeled bus time and the dumped frame are checked. A hardware scroll
+ *    must keep the areas a scroll handler invalidates outside the band.
+ *    Then the panel IO is marked lost and a redraw must return without
+ *    any draw.
+ *
+ * Usage: test_virtual_panel [output directory for the PPM files]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_lcd_panel_interface.h"
+#include "esp_timer.h"
+#include "ST7789.h"
+#include "Virtual_Panel/Virtual_Panel.h"
+#include "LVGL_Driver.h"
+#include "LVGL_Example.h"
+
+#define VIEW_W      172
+#define VIEW_H      320
+#define BAND_ROWS   20
+#define PCLK_HZ     (12 * 1000 * 1000)
+#define OVERHEAD_US 8
+#define CMD_BYTES   11      // CASET + 4, RASET + 4, RAMWR
+
+static int failures;
+
+#define CHECK(cond, ...) do {                                       \
+        if (!(cond)) {                                              \
+            printf("FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond);  \
+            printf(__VA_ARGS__);                                    \
+            printf("\n");                                           \
+            failures++;                                             \
+        }                                                           \
+    } while (0)
+
+/**
+ * Modeled bus time of one draw_bitmap call
+ */
+static uint64_t draw_cost_us(uint32_t pixel_bytes)
+{
+    return 3 * OVERHEAD_US + ((uint64_t)(CMD_BYTES + pixel_bytes) * 8 * 1000000 + PCLK_HZ - 1) / PCLK_HZ;
+}
+
+static void wait_idle(esp_lcd_panel_handle_t panel)
+{
+    int64_t start = esp_timer_get_time();
+    while (esp_lcd_panel_virtual_is_busy(panel) && esp_timer_get_time() - start < 2000000) {
+        vTaskDelay(1);
+    }
+}
+
+/**
+ * Read a PPM written by esp_lcd_panel_virtual_dump_ppm()
+ * @return RGB888 pixels (VIEW_W x VIEW_H), NULL if the file is not a
+ *         VIEW_W x VIEW_H P6 image
+ */
+static uint8_t *read_ppm(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        printf("FAIL: cannot open %s\n", path);
+        return NULL;
+    }
+    char header[32];
+    int header_len = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", VIEW_W, VIEW_H);
+    char actual[32] = {0};
+    size_t size = (size_t)VIEW_W * VIEW_H * 3;
+    uint8_t *rgb = malloc(size + 1);
+
+    bool ok = fread(actual, 1, header_len, f) == (size_t)header_len &&
+              memcmp(actual, header, header_len) == 0 &&
+              fread(rgb, 1, size + 1, f) == size;      // No trailing bytes
+    fclose(f);
+    CHECK(ok, "%s is not a %dx%d P6 image", path, VIEW_W, VIEW_H);
+    if (!ok) {
+        free(rgb);
+        return NULL;
+    }
+    return rgb;
+}
+
+static bool done_cb(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    (void)panel;
+    __atomic_add_fetch((int *)user_ctx, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+/**
+ * Draw 16 bands (red left half, blue / green right half) the way the ST7789
+ * driver sets up the panel, then check stats and image
+ */
+static void test_raw_panel(const char *dir)
+{
+    printf("--- raw panel\n");
+    int done = 0;
+    esp_lcd_panel_virtual_config_t config = {
+        .ram_cols = ST7789_RAM_COLS,
+        .ram_rows = ST7789_RAM_ROWS,
+        .view_x = 34,
+        .view_width = VIEW_W,
+        .view_height = VIEW_H,
+        .pclk_hz = PCLK_HZ,
+        .trans_overhead_us = OVERHEAD_US,
+        .on_color_trans_done = done_cb,
+        .user_ctx = &done,
+        .flags = {
+            .view_mirror_x = 1,
+            .pixel_le = 1,
+            .realtime = 1,
+        },
+    };
+    esp_lcd_panel_handle_t panel;
+    esp_err_t ret = esp_lcd_new_panel_virtual(&config, &panel);
+    CHECK(ret == ESP_OK, "esp_lcd_new_panel_virtual: %s", esp_err_to_name(ret));
+    if (ret != ESP_OK) {
+        return;
+    }
+    esp_lcd_panel_mirror(panel, true, false);
+
+    static uint16_t band[VIEW_W * BAND_ROWS];
+    for (int b = 0; b < VIEW_H / BAND_ROWS; b++) {
+        for (int i = 0; i < VIEW_W * BAND_ROWS; i++) {
+            band[i] = i % VIEW_W < VIEW_W / 2 ? 0xF800 : (b & 1 ? 0x07E0 : 0x001F);
+        }
+        // The done callback of the previous band releases the buffer
+        wait_idle(panel);
+        esp_lcd_panel_draw_bitmap(panel, 34, b * BAND_ROWS, 34 + VIEW_W, (b + 1) * BAND_ROWS, band);
+    }
+    wait_idle(panel);
+
+    uint32_t bands = VIEW_H / BAND_ROWS;
+    uint32_t band_bytes = VIEW_W * BAND_ROWS * 2;
+    esp_lcd_panel_virtual_stats_t stats;
+    esp_lcd_panel_virtual_get_stats(panel, &stats);
+    printf("draws %u, transactions %u, cmd %llu B, pixels %llu B, bus %llu us\n",
+           stats.draws, stats.transactions, (unsigned long long)stats.cmd_bytes,
+           (unsigned long long)stats.pixel_bytes, (unsigned long long)stats.bus_time_us);
+    CHECK(done == (int)bands, "done callbacks: %d", done);
+    CHECK(stats.draws == bands, "draws: %u", stats.draws);
+    CHECK(stats.transactions == 3 * bands, "transactions: %u", stats.transactions);
+    CHECK(stats.cmd_bytes == CMD_BYTES * bands, "cmd_bytes: %llu", (unsigned long long)stats.cmd_bytes);
+    CHECK(stats.pixel_bytes == (uint64_t)band_bytes * bands, "pixel_bytes: %llu", (unsigned long long)stats.pixel_bytes);
+    CHECK(stats.bus_time_us == draw_cost_us(band_bytes) * bands, "bus_time_us: %llu, expected %llu",
+          (unsigned long long)stats.bus_time_us, (unsigned long long)(draw_cost_us(band_bytes) * bands));
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/raw_panel.ppm", dir);
+    ret = esp_lcd_panel_virtual_dump_ppm(panel, path);
+    CHECK(ret == ESP_OK, "dump_ppm: %s", esp_err_to_name(ret));
+    uint8_t *rgb = read_ppm(path);
+    if (rgb != NULL) {
+        // Upright: red on the left, the right half alternates blue / green
+        const uint8_t *top_left = rgb;
+        const uint8_t *top_right = rgb + (VIEW_W - 1) * 3;
+        const uint8_t *second_band_right = rgb + ((size_t)BAND_ROWS * VIEW_W + VIEW_W - 1) * 3;
+        CHECK(top_left[0] == 255 && top_left[1] == 0 && top_left[2] == 0, "top left %u,%u,%u",
+              top_left[0], top_left[1], top_left[2]);
+        CHECK(top_right[0] == 0 && top_right[1] == 0 && top_right[2] == 255, "top right %u,%u,%u",
+              top_right[0], top_right[1], top_right[2]);
+        CHECK(second_band_right[0] == 0 && second_band_right[1] == 255 && second_band_right[2] == 0,
+              "second band right %u,%u,%u", second_band_right[0], second_band_right[1], second_band_right[2]);
+        free(rgb);
+    }
+    esp_lcd_panel_del(panel);
+}
+
+/**
+ * Tiny draws issued without waiting for the previous one. The done timer
+ * gets dispatch latency, so some draws land after it expired but before its
+ * callback ran.
+ */
+static void test_back_to_back(void)
+{
+    printf("--- back to back\n");
+    int done = 0;
+    esp_lcd_panel_virtual_config_t config = {
+        .ram_cols = ST7789_RAM_COLS,
+        .ram_rows = ST7789_RAM_ROWS,
+        .view_width = VIEW_W,
+        .view_height = VIEW_H,
+        .pclk_hz = PCLK_HZ,
+        .trans_overhead_us = OVERHEAD_US,
+        .on_color_trans_done = done_cb,
+        .user_ctx = &done,
+        .flags = {
+            .realtime = 1,
+        },
+    };
+    esp_lcd_panel_handle_t panel;
+    esp_err_t ret = esp_lcd_new_panel_virtual(&config, &panel);
+    CHECK(ret == ESP_OK, "esp_lcd_new_panel_virtual: %s", esp_err_to_name(ret));
+    if (ret != ESP_OK) {
+        return;
+    }
+
+    static const uint16_t pixel = 0xFFFF;
+    const int draws = 2000;
+    const uint32_t latency_us = 200;
+    uint32_t cost_us = (uint32_t)draw_cost_us(2);
+    esp_timer_host_set_dispatch_latency(latency_us);
+    srand(1);
+    for (int i = 0; i < draws; i++) {
+        esp_lcd_panel_draw_bitmap(panel, 0, 0, 1, 1, &pixel);
+        int64_t until = esp_timer_get_time() + rand() % (cost_us + 2 * latency_us);
+        while (esp_timer_get_time() < until) {
+        }
+    }
+    wait_idle(panel);
+    esp_timer_host_set_dispatch_latency(0);
+    int reported = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+    printf("draws %d, done callbacks %d\n", draws, reported);
+    CHECK(reported == draws, "done callbacks %d for %d draws", reported, draws);
+    CHECK(!esp_lcd_panel_virtual_is_busy(panel), "still busy");
+    esp_lcd_panel_del(panel);
+}
+
+static void scroll_restyle_cb(lv_event_t *e)
+{
+    lv_obj_t *status = lv_event_get_user_data(e);
+    lv_obj_set_style_bg_color(status, lv_palette_main(LV_PALETTE_RED), 0);
+}
+
+/**
+ * Hardware scroll of a band: of the band only the exposed rows are
+ * redrawn, while the status bar a scroll handler restyles and the part of
+ * the band object's own redraw outside the band (its outline) are kept
+ */
+static void test_scroll(lvgl_driver_t *lvgl)
+{
+    printf("--- scroll\n");
+    const int top = 100;
+    const int height = 120;
+    const int dy = 10;
+
+    esp_err_t ret = lvgl_driver_set_scroll_area(lvgl, top, height);
+    CHECK(ret == ESP_OK, "set_scroll_area: %s", esp_err_to_name(ret));
+    if (ret != ESP_OK || !lvgl_driver_lock(lvgl, -1)) {
+        return;
+    }
+
+    lv_obj_t *status = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(status, 0, 0);
+    lv_obj_set_size(status, VIEW_W, 20);
+    lv_obj_t *band = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(band, 0, top);
+    lv_obj_set_size(band, VIEW_W, height);
+    lv_obj_set_scrollbar_mode(band, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_t *content = lv_obj_create(band);
+    lv_obj_set_size(content, VIEW_W, 4 * height);
+    lv_obj_add_event_cb(band, scroll_restyle_cb, LV_EVENT_SCROLL, status);
+    lv_refr_now(NULL);
+
+    lv_disp_t *disp = lv_disp_get_default();
+    ret = lvgl_driver_scroll(lvgl, band, dy);
+    CHECK(ret == ESP_OK, "scroll: %s", esp_err_to_name(ret));
+
+    bool status_kept = false;
+    bool outside_kept = false;
+    int band_areas = 0;
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+        const lv_area_t *a = &disp->inv_areas[i];
+        if (a->y1 >= top && a->y2 < top + height) {
+            band_areas++;
+            CHECK(a->y1 == top + height - dy, "band area rows %d-%d, not only the exposed rows",
+                  (int)a->y1, (int)a->y2);
+        } else {
+            CHECK(a->y2 < top || a->y1 >= top + height, "area rows %d-%d cross the band edge",
+                  (int)a->y1, (int)a->y2);
+            status_kept |= a->y1 == 0;
+            outside_kept |= a->y1 == top + height;
+        }
+    }
+    printf("invalidated: %u areas, %d in the band\n", disp->inv_p, band_areas);
+    CHECK(status_kept, "status bar invalidation dropped");
+    CHECK(outside_kept, "band redraw below the band dropped");
+    CHECK(band_areas == 1, "%d areas in the band", band_areas);
+
+    lv_refr_now(NULL);
+    lv_obj_del(band);
+    lv_obj_del(status);
+    lvgl_driver_unlock(lvgl);
+    lvgl_driver_set_scroll_area(lvgl, 0, 0);
+}
+
+/**
+ * Boot sequence of app_main on the virtual panel, first frame of the demo UI
+ */
+static void test_first_frame(const char *dir)
+{
+    printf("--- first frame\n");
+    st7789_config_t lcd_config = st7789_get_default_config();
+    st7789_device_t *lcd = st7789_create(&lcd_config);
+    CHECK(lcd != NULL, "st7789_create");
+    if (lcd == NULL) {
+        return;
+    }
+    esp_err_t ret = st7789_init(lcd);
+    CHECK(ret == ESP_OK, "st7789_init: %s", esp_err_to_name(ret));
+    CHECK(st7789_is_virtual(lcd), "not a virtual panel");
+
+    lvgl_config_t lvgl_config = lvgl_get_default_config(lcd);
+    lvgl_driver_t *lvgl = lvgl_driver_create(&lvgl_config);
+    CHECK(lvgl != NULL, "lvgl_driver_create");
+    if (ret != ESP_OK || lvgl == NULL) {
+        return;
+    }
+    ret = lvgl_driver_init(lvgl);
+    CHECK(ret == ESP_OK, "lvgl_driver_init: %s", esp_err_to_name(ret));
+    if (ret != ESP_OK) {
+        return;
+    }
+
+    esp_lcd_panel_virtual_reset_stats(lcd->panel_handle);
+    int64_t start = esp_timer_get_time();
+    if (lvgl_driver_lock(lvgl, -1)) {
+        Lvgl_Example1();
+        lv_refr_now(NULL);
+        lvgl_driver_unlock(lvgl);
+    }
+    wait_idle(lcd->panel_handle);
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    esp_lcd_panel_virtual_stats_t stats;
+    esp_lcd_panel_virtual_get_stats(lcd->panel_handle, &stats);
+    printf("draws %u, pixels %llu B, bus %llu us, wall %lld us\n", stats.draws,
+           (unsigned long long)stats.pixel_bytes, (unsigned long long)stats.bus_time_us, (long long)elapsed);
+
+    // The first frame covers the whole screen at least once
+    uint64_t frame_bytes = (uint64_t)VIEW_W * VIEW_H * 2;
+    CHECK(stats.draws > 0, "no draws");
+    CHECK(stats.pixel_bytes >= frame_bytes, "pixel_bytes %llu < %llu",
+          (unsigned long long)stats.pixel_bytes, (unsigned long long)frame_bytes);
+    CHECK(stats.transactions == 3 * stats.draws, "transactions: %u", stats.transactions);
+    CHECK(stats.cmd_bytes == (uint64_t)CMD_BYTES * stats.draws, "cmd_bytes: %llu",
+          (unsigned long long)stats.cmd_bytes);
+
+    // Bus time: every draw costs the overhead plus its bytes at 12 MHz,
+    // rounded up to whole microseconds per draw
+    uint64_t wire_us = (stats.cmd_bytes + stats.pixel_bytes) * 8 * 1000000 / PCLK_HZ;
+    uint64_t min_us = wire_us + 3 * OVERHEAD_US * stats.draws;
+    CHECK(stats.bus_time_us >= min_us && stats.bus_time_us <= min_us + stats.draws,
+          "bus_time_us %llu, expected %llu..%llu", (unsigned long long)stats.bus_time_us,
+          (unsigned long long)min_us, (unsigned long long)(min_us + stats.draws));
+    // Realtime mode: the frame cannot complete faster than the modeled bus
+    CHECK(elapsed >= (int64_t)stats.bus_time_us, "wall %lld us < bus %llu us",
+          (long long)elapsed, (unsigned long long)stats.bus_time_us);
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/first_frame.ppm", dir);
+    ret = esp_lcd_panel_virtual_dump_ppm(lcd->panel_handle, path);
+    CHECK(ret == ESP_OK, "dump_ppm: %s", esp_err_to_name(ret));
+    uint8_t *rgb = read_ppm(path);
+    if (rgb != NULL) {
+        // The demo UI: a light background with darker text and widgets
+        uint32_t light = 0;
+        uint32_t dark = 0;
+        for (size_t i = 0; i < (size_t)VIEW_W * VIEW_H; i++) {
+            uint32_t sum = rgb[3 * i] + rgb[3 * i + 1] + rgb[3 * i + 2];
+            light += sum > 600;
+            dark += sum < 300;
+        }
+        printf("light %u, dark %u of %u pixels\n", light, dark, VIEW_W * VIEW_H);
+        CHECK(light > VIEW_W * VIEW_H / 2, "mostly not light: %u", light);
+        CHECK(dark > 100, "no text or widgets drawn: %u dark pixels", dark);
+        free(rgb);
+    }
+
+    lvgl_driver_dump_metrics(lvgl);
+
+    test_scroll(lvgl);
+
+    // Panel IO lost (failed pixel clock restore): flushes are dropped at
+    // once instead of waiting for a transfer that never starts
+    lcd->is_initialized = false;
+    esp_lcd_panel_virtual_reset_stats(lcd->panel_handle);
+    start = esp_timer_get_time();
+    if (lvgl_driver_lock(lvgl, -1)) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+        lvgl_driver_unlock(lvgl);
+    }
+    elapsed = esp_timer_get_time() - start;
+    esp_lcd_panel_virtual_get_stats(lcd->panel_handle, &stats);
+    CHECK(stats.draws == 0, "draws after IO loss: %u", stats.draws);
+    CHECK(elapsed < 100000, "redraw after IO loss took %lld us", (long long)elapsed);
+    lcd->is_initialized = true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = argc > 1 ? argv[1] : ".";
+
+    test_raw_panel(dir);
+    test_back_to_back();
+    test_first_frame(dir);
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+/*****************************************************************************
+  | File        :   Pixel_Ops.c
+  | Function    :   RGB565 pixel kernels shared by all pixel paths
+  | Info        :
+    See Pixel_Ops.h. Word accesses go through pixel_word_t, which may alias
+    the uint16_t buffers, and only happen once the pointers are 4-byte
+    aligned: the C6 traps on misaligned word loads and stores.
+******************************************************************************/
+#include "Pixel_Ops.h"
+
+typedef uint32_t __attribute__((may_alias)) pixel_word_t;
+
+#define PIXEL_IS_WORD_ALIGNED(p)    ((((uintptr_t)(p)) & 3) == 0)
+
+/********************************************************************************
+ * Color Conversion
+ ********************************************************************************/
+size_t pixel_565_to_444(uint8_t *dst, const uint16_t *src, size_t count)
+{
+    uint8_t *out = dst;
+
+    // Keep the top 4 bits of each channel: R 15..12, G 10..7, B 4..1
+    for (; count >= 2; count -= 2) {
+        uint32_t p0 = src[0];
+        uint32_t p1 = src[1];
+        src += 2;
+        out[0] = (uint8_t)(((p0 >> 8) & 0xF0) | ((p0 >> 7) & 0x0F));
+        out[1] = (uint8_t)(((p0 << 3) & 0xF0) | (p1 >> 12));
+        out[2] = (uint8_t)(((p1 >> 3) & 0xF0) | ((p1 >> 1) & 0x0F));
+        out += 3;
+    }
+    if (count > 0) {
+        uint32_t p = src[0];
+        out[0] = (uint8_t)(((p >> 8) & 0xF0) | ((p >> 7) & 0x0F));
+        out[1] = (uint8_t)((p << 3) & 0xF0);
+        out += 2;
+    }
+    return (size_t)(out - dst);
+}
+
+/********************************************************************************
+ * Fill and Compare
+ ********************************************************************************/
+void pixel_fill565(uint16_t *dst, uint16_t color, size_t count)
+{
+    if (count > 0 && !PIXEL_IS_WORD_ALIGNED(dst)) {
+        *dst++ = color;
+        count--;
+    }
+
+    uint32_t pair = color | ((uint32_t)color << 16);
+    pixel_word_t *d = (pixel_word_t *)dst;
+    for (; count >= 8; count -= 8) {
+        d[0] = pair;
+        d[1] = pair;
+        d[2] = pair;
+        d[3] = pair;
+        d += 4;
+    }
+    for (; count >= 2; count -= 2) {
+        *d++ = pair;
+    }
+    dst = (uint16_t *)d;
+
+    if (count > 0) {
+        *dst = color;
+    }
+}
+
+bool pixel_is_solid565(const uint16_t *src, size_t count)
+{
+    if (count == 0) {
+        return true;
+    }
+
+    const uint16_t color = src[0];
+    if (!PIXEL_IS_WORD_ALIGNED(src)) {
+        src++;
+        count--;
+    }
+
+    uint32_t pair = color | ((uint32_t)color << 16);
+    const pixel_word_t *s = (const pixel_word_t *)src;
+    for (; count >= 8; count -= 8) {
+        if ((s[0] ^ pair) | (s[1] ^ pair) | (s[2] ^ pair) | (s[3] ^ pair)) {
+            return false;
+        }
+        s += 4;
+    }
+    for (; count >= 2; count -= 2) {
+        if (*s++ != pair) {
+            return false;
+        }
+    }
+    src = (const uint16_t *)s;
+
+    return count == 0 || *src == color;
+}
+
+/********************************************************************************
+ * Host Micro-Benchmark (see Pixel_Ops.h)
+ ********************************************************************************/
+#ifdef PIXEL_OPS_BENCHMARK
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_PIXELS    (172 * 320)
+#define BENCH_ROUNDS    200
+
+static uint16_t bench_src[BENCH_PIXELS + 2];
+static uint16_t bench_dst[BENCH_PIXELS + 2];
+static uint16_t bench_ref[BENCH_PIXELS + 2];
+static uint8_t bench_444[BENCH_PIXELS * 2];
+static volatile uint32_t bench_sink;
+
+static double bench_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void bench_report(const char *name, double kernel_us, double naive_us, bool ok)
+{
+    printf("%-16s %9.1f us/frame  per-pixel loop %9.1f us/frame  x%.2f  %s\n", name,
+           kernel_us / BENCH_ROUNDS, naive_us / BENCH_ROUNDS, naive_us / kernel_us, ok ? "ok" : "MISMATCH");
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < BENCH_PIXELS + 2; i++) {
+        bench_src[i] = (uint16_t)(i * 2654435761u >> 7);
+    }
+    printf("%d pixels (one 172x320 frame), %d rounds\n", BENCH_PIXELS, BENCH_ROUNDS);
+
+    // RGB565 -> RGB444, checked against a per-pixel bit packer
+    static uint8_t ref_444[BENCH_PIXELS * 2];
+    double t0 = bench_now_us();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        memset(ref_444, 0, sizeof(ref_444));
+        for (size_t i = 0; i < BENCH_PIXELS; i++) {
+            uint16_t p = bench_src[i];
+            uint32_t c = ((p >> 12) << 8) | (((p >> 7) & 0xF) << 4) | ((p >> 1) & 0xF);
+            size_t bit = i * 12;
+            ref_444[bit / 8] |= (bit % 8) ? (uint8_t)(c >> 8) : (uint8_t)(c >> 4);
+            ref_444[bit / 8 + 1] |= (bit % 8) ? (uint8_t)c : (uint8_t)(c << 4);
+        }
+        bench_sink += ref_444[r];
+    }
+    double t1 = bench_now_us();
+    size_t len = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        len = pixel_565_to_444(bench_444, bench_src, BENCH_PIXELS);
+        bench_sink += bench_444[r];
+    }
+    double t2 = bench_now_us();
+    bench_report("565_to_444", t2 - t1, t1 - t0,
+                 len == pixel_444_bytes(BENCH_PIXELS) && memcmp(bench_444, ref_444, len) == 0);
+
+    // Fill
+    t0 = bench_now_us();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (size_t i = 0; i < BENCH_PIXELS; i++) {
+            bench_ref[i + 1] = (uint16_t)r;
+        }
+        bench_sink += bench_ref[r + 1];
+    }
+    t1 = bench_now_us();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        pixel_fill565(bench_dst + 1, (uint16_t)r, BENCH_PIXELS);
+        bench_sink += bench_dst[r + 1];
+    }
+    t2 = bench_now_us();
+    bench_report("fill565 (odd)", t2 - t1, t1 - t0, memcmp(bench_dst + 1, bench_ref + 1, BENCH_PIXELS * 2) == 0);
+
+    // Solid check on a solid frame (worst case: every pixel is read)
+    t0 = bench_now_us();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        bool solid = true;
+        for (size_t i = 1; i < BENCH_PIXELS; i++) {
+            if (bench_dst[i + 1] != bench_dst[1]) {
+                solid = false;
+                break;
+            }
+        }
+        bench_sink += solid;
+    }
+    t1 = bench_now_us();
+    bool solid = false;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        solid = pixel_is_solid565(bench_dst + 1, BENCH_PIXELS);
+        bench_sink += solid;
+    }
+    t2 = bench_now_us();
+    bench_dst[BENCH_PIXELS] ^= 1;
+    bench_report("is_solid565", t2 - t1, t1 - t0, solid && !pixel_is_solid565(bench_dst + 1, BENCH_PIXELS));
+
+    return 0;
+}
+#endif
@@ -0,0 +1,70 @@
+/*****************************************************************************
+  | File        :   Pixel_Ops.h
+  | Function    :   RGB565 pixel kernels shared by all pixel paths
+  | Info        :
+    Color conversion, fill and compare for RGB565 buffers. The
+    ESP32-C6 core (RV32IMAC) has no SIMD and no byte-reverse instruction,
+    so the kernels work on two pixels per 32-bit word with mask/shift and
+    fall back to single pixels only for unaligned heads and odd tails.
+
+    The same files are used by the ESP-IDF project and the Arduino
+    sketches. Keep every copy byte-identical.
+
+    Build Pixel_Ops.c on its own to get a host micro-benchmark comparing
+    each kernel against a per-pixel loop:
+        cc -O2 -fno-tree-vectorize -DPIXEL_OPS_BENCHMARK Pixel_Ops.c
+    (-fno-tree-vectorize keeps the host compiler from using SIMD, which
+    the C6 does not have.)
+******************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Convert RGB565 to packed RGB444 (ST7789 COLMOD 12-bit)
+ *
+ * Two pixels are packed into three bytes in wire order: R0G0 B0R1 G1B1.
+ * An odd last pixel takes two bytes (R G, B 0).
+ *
+ * @param dst Destination bytes, at least pixel_444_bytes(count)
+ * @param src Source pixels (CPU byte order)
+ * @param count Number of pixels
+ * @return Number of bytes written
+ */
+size_t pixel_565_to_444(uint8_t *dst, const uint16_t *src, size_t count);
+
+/**
+ * @brief Bytes needed for count pixels in packed RGB444
+ */
+static inline size_t pixel_444_bytes(size_t count)
+{
+    return (count * 3 + 1) / 2;
+}
+
+/**
+ * @brief Fill a pixel buffer with one color
+ *
+ * @param dst Destination pixels
+ * @param color RGB565 color (stored as is)
+ * @param count Number of pixels
+ */
+void pixel_fill565(uint16_t *dst, uint16_t color, size_t count);
+
+/**
+ * @brief Check if all pixels have the same color
+ *
+ * @param src Pixels
+ * @param count Number of pixels
+ * @return true if count is 0 or every pixel equals src[0]
+ */
+bool pixel_is_solid565(const uint16_t *src, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,9 @@
  #include "ST7789.h"
  #include <stdlib.h>
  #include <string.h>
+ #include "esp_heap_caps.h"
+ #include "esp_lcd_panel_commands.h"
+ #include "Pixel_Ops.h"
  
  /******************************************************************************
   * Private Constants and Macros
@@ -20,6 +23,12 @@
  #define BRIGHTNESS_MIN              0
  #define BRIGHTNESS_MAX              100
  
+ // Normal mode refresh rate for each FRCTRL2 RTNA value (datasheet, FPA = BPA = 12)
+ static const uint8_t frame_rate_table[32] = {
+     119, 111, 105, 99, 94, 90, 86, 82, 78, 75, 72, 69, 67, 64, 62, 60,
+     58, 57, 55, 53, 52, 50, 49, 48, 46, 45, 44, 43, 42, 41, 40, 39,
+ };
+ 
  /******************************************************************************
   * Private Function Prototypes
   ******************************************************************************/
@@ -28,6 +37,15 @@
  static esp_err_t backlight_deinit(st7789_backlight_t *backlight);
  static esp_err_t backlight_set_duty(st7789_backlight_t *backlight, uint8_t brightness);
  static uint16_t brightness_to_duty(uint8_t brightness);
+ static void init_task(void *arg);
+ #if !CONFIG_LCD_VIRTUAL_PANEL
+ static bool color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+ static esp_err_t panel_io_create(st7789_device_t *device, int pclk_hz);
+ #endif
+ #if CONFIG_LCD_VIRTUAL_PANEL
+ static esp_err_t virtual_panel_create(st7789_device_t *device);
+ static bool virtual_trans_done(esp_lcd_panel_handle_t panel, void *user_ctx);
+ #endif
  
  /******************************************************************************
   * Public API Implementation
@@ -106,24 +124,18 @@
      
      esp_err_t ret;
      
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     // Steps 1-2: In-memory panel instead of SPI IO + ST7789T
+     ret = virtual_panel_create(device);
+     if (ret != ESP_OK) {
+         ESP_LOGE(TAG, "Failed to create virtual panel: %s", esp_err_to_name(ret));
+         return ret;
+     }
+ #else
      // Step 1: Install panel IO
      ESP_LOGI(TAG, "Installing panel IO interface");
      
-     esp_lcd_panel_io_spi_config_t io_config = {
-         .dc_gpio_num = device->config.pin_dc,
-         .cs_gpio_num = device->config.pin_cs,
-         .pclk_hz = device->config.pixel_clock_hz,
-         .lcd_cmd_bits = ST7789_CMD_BITS,
-         .lcd_param_bits = ST7789_PARAM_BITS,
-         .spi_mode = 0,
-         .trans_queue_depth = 10,
-         .on_color_trans_done = NULL,  // No callback (LVGL will handle flushing)
-         .user_ctx = NULL,
-     };
-     
-     ret = esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)device->config.spi_host, 
-                                     &io_config, 
-                                     &device->io_handle);
+     ret = panel_io_create(device, device->config.pixel_clock_hz);
      if (ret != ESP_OK) {
          ESP_LOGE(TAG, "Failed to create panel IO: %s", esp_err_to_name(ret));
          return ret;
@@ -143,9 +155,11 @@
          ESP_LOGE(TAG, "Failed to create ST7789T panel: %s", esp_err_to_name(ret));
          return ret;
      }
+ #endif
      
      // Step 3: Reset and initialize panel
      ESP_LOGI(TAG, "Resetting and initializing panel");
+     int64_t init_start = esp_timer_get_time();
      
      ret = esp_lcd_panel_reset(device->panel_handle);
      if (ret != ESP_OK) {
@@ -153,6 +167,14 @@
          return ret;
      }
      
+     // Reset does not block: set up the backlight (duty 0) while the panel recovers
+     ESP_LOGI(TAG, "Initializing backlight controller");
+     ret = backlight_init(&device->backlight, device->config.pin_backlight);
+     if (ret != ESP_OK) {
+         ESP_LOGE(TAG, "Backlight initialization failed: %s", esp_err_to_name(ret));
+         return ret;
+     }
+     
      ret = esp_lcd_panel_init(device->panel_handle);
      if (ret != ESP_OK) {
          ESP_LOGE(TAG, "Panel initialization failed: %s", esp_err_to_name(ret));
@@ -172,27 +194,68 @@
          ESP_LOGE(TAG, "Failed to turn on display: %s", esp_err_to_name(ret));
          return ret;
      }
+     device->init_time_us = esp_timer_get_time() - init_start;
+     ESP_LOGI(TAG, "Panel reset to display on: %lld us", (long long)device->init_time_us);
      
-     // Step 6: Initialize backlight
-     ESP_LOGI(TAG, "Initializing backlight controller");
-     ret = backlight_init(&device->backlight, device->config.pin_backlight);
-     if (ret != ESP_OK) {
-         ESP_LOGE(TAG, "Backlight initialization failed: %s", esp_err_to_name(ret));
-         return ret;
-     }
-     
-     // Set initial brightness
+     // Step 6: Set initial brightness
      ret = st7789_backlight_set(device, device->config.initial_brightness);
      if (ret != ESP_OK) {
          ESP_LOGW(TAG, "Failed to set initial brightness: %s", esp_err_to_name(ret));
      }
      
+     device->frame_rate_hz = ST7789_FRAME_RATE_HZ;
      device->is_initialized = true;
      ESP_LOGI(TAG, "LCD device initialized successfully");
      
      return ESP_OK;
  }
  
+ /**
+  * @brief Initialize LCD device in a background task
+  */
+ esp_err_t st7789_init_async(st7789_device_t *device)
+ {
+     if (device == NULL) {
+         return ESP_ERR_INVALID_ARG;
+     }
+     
+     if (device->init_events == NULL) {
+         device->init_events = xEventGroupCreate();
+         if (device->init_events == NULL) {
+             return ESP_ERR_NO_MEM;
+         }
+     }
+     xEventGroupClearBits(device->init_events, ST7789_INIT_DONE_BIT);
+     
+     if (xTaskCreate(init_task, "lcd_init", ST7789_INIT_TASK_STACK, device,
+                     ST7789_INIT_TASK_PRIORITY, NULL) != pdPASS) {
+         ESP_LOGE(TAG, "Failed to create init task");
+         return ESP_ERR_NO_MEM;
+     }
+     return ESP_OK;
+ }
+ 
+ /**
+  * @brief Wait for the background initialization
+  */
+ esp_err_t st7789_wait_init(st7789_device_t *device, int timeout_ms)
+ {
+     if (device == NULL) {
+         return ESP_ERR_INVALID_ARG;
+     }
+     if (device->init_events == NULL) {
+         return device->is_initialized ? ESP_OK : ESP_ERR_INVALID_STATE;
+     }
+     
+     TickType_t ticks = (timeout_ms < 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+     EventBits_t bits = xEventGroupWaitBits(device->init_events, ST7789_INIT_DONE_BIT,
+                                            pdFALSE, pdTRUE, ticks);
+     if (!(bits & ST7789_INIT_DONE_BIT)) {
+         return ESP_ERR_TIMEOUT;
+     }
+     return device->init_result;
+ }
+ 
  /**
   * @brief Destroy LCD device object
   */
@@ -205,6 +268,10 @@
      // Deinitialize backlight
      backlight_deinit(&device->backlight);
      
+     if (device->init_events != NULL) {
+         vEventGroupDelete(device->init_events);
+     }
+     
      // Note: Panel handles are managed by ESP-IDF driver framework
      // They will be automatically cleaned up
      
@@ -275,6 +342,326 @@
      return device->panel_handle;
  }
  
+ /**
+  * @brief Get window address cache statistics
+  */
+ esp_err_t st7789_get_window_stats(st7789_device_t *device, esp_lcd_st7789t_window_stats_t *stats)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     return ESP_ERR_NOT_SUPPORTED;
+ #else
+     return esp_lcd_st7789t_get_window_stats(device->panel_handle, stats);
+ #endif
+ }
+ 
+ esp_err_t st7789_register_trans_done_cb(st7789_device_t *device, st7789_trans_done_cb_t callback, void *user_ctx)
+ {
+     if (device == NULL) {
+         return ESP_ERR_INVALID_ARG;
+     }
+     
+     // Clear the callback first so the ISR never sees a new callback with an old context
+     device->trans_done_cb = NULL;
+     device->trans_done_ctx = user_ctx;
+     device->trans_done_cb = callback;
+     return ESP_OK;
+ }
+ 
+ /**
+  * @brief Change the SPI pixel clock
+  */
+ esp_err_t st7789_set_pixel_clock(st7789_device_t *device, int pclk_hz)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     if (pclk_hz <= 0) {
+         return ESP_ERR_INVALID_ARG;
+     }
+     if (pclk_hz == device->config.pixel_clock_hz) {
+         return ESP_OK;
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     esp_err_t ret = esp_lcd_panel_virtual_set_pclk(device->panel_handle, pclk_hz);
+ #else
+     // Deleting the IO waits for queued transfers, their done callbacks still run
+     esp_err_t ret = esp_lcd_panel_io_del(device->io_handle);
+     if (ret != ESP_OK) {
+         ESP_LOGE(TAG, "Failed to delete panel IO: %s", esp_err_to_name(ret));
+         return ret;
+     }
+     device->io_handle = NULL;
+     esp_lcd_st7789t_set_io(device->panel_handle, NULL);
+     
+     ret = panel_io_create(device, pclk_hz);
+     if (ret != ESP_OK) {
+         ESP_LOGE(TAG, "Failed to create panel IO at %d Hz: %s", pclk_hz, esp_err_to_name(ret));
+         // Go back to the old clock so the panel stays usable
+         esp_err_t restore = panel_io_create(device, device->config.pixel_clock_hz);
+         if (restore != ESP_OK) {
+             // No IO left: the panel stays detached and the device unusable
+             ESP_LOGE(TAG, "Failed to restore panel IO at %d Hz: %s",
+                      device->config.pixel_clock_hz, esp_err_to_name(restore));
+             device->is_initialized = false;
+             return ESP_ERR_INVALID_STATE;
+         }
+         esp_lcd_st7789t_set_io(device->panel_handle, device->io_handle);
+         return ret;
+     }
+     ret = esp_lcd_st7789t_set_io(device->panel_handle, device->io_handle);
+ #endif
+     if (ret != ESP_OK) {
+         return ret;
+     }
+     
+     ESP_LOGI(TAG, "Pixel clock changed: %d -> %d Hz", device->config.pixel_clock_hz, pclk_hz);
+     device->config.pixel_clock_hz = pclk_hz;
+     return ESP_OK;
+ }
+ 
+ /**
+  * @brief Change the color depth of the pixel transfers
+  */
+ esp_err_t st7789_set_color_depth(st7789_device_t *device, uint8_t bits_per_pixel)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     if (bits_per_pixel != 12 && bits_per_pixel != 16) {
+         return ESP_ERR_INVALID_ARG;
+     }
+     if (bits_per_pixel == device->config.bits_per_pixel) {
+         return ESP_OK;
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     esp_err_t ret = esp_lcd_panel_virtual_set_bits_per_pixel(device->panel_handle, bits_per_pixel);
+ #else
+     esp_err_t ret = esp_lcd_st7789t_set_bits_per_pixel(device->panel_handle, bits_per_pixel);
+ #endif
+     if (ret != ESP_OK) {
+         ESP_LOGE(TAG, "Failed to set %d bpp: %s", bits_per_pixel, esp_err_to_name(ret));
+         return ret;
+     }
+     
+     ESP_LOGI(TAG, "Color depth: %d bpp", bits_per_pixel);
+     device->config.bits_per_pixel = bits_per_pixel;
+     return ESP_OK;
+ }
+ 
+ /**
+  * @brief Define the hardware vertical scroll area
+  */
+ esp_err_t st7789_set_scroll_area(st7789_device_t *device, uint16_t top_fixed, uint16_t scroll_lines, uint16_t bottom_fixed)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     return esp_lcd_panel_virtual_set_scroll_area(device->panel_handle, top_fixed, scroll_lines, bottom_fixed);
+ #else
+     return esp_lcd_st7789t_set_scroll_area(device->panel_handle, top_fixed, scroll_lines, bottom_fixed);
+ #endif
+ }
+ 
+ /**
+  * @brief Set the hardware scroll start address
+  */
+ esp_err_t st7789_set_scroll_start(st7789_device_t *device, uint16_t line)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     return esp_lcd_panel_virtual_set_scroll_start(device->panel_handle, line);
+ #else
+     return esp_lcd_st7789t_set_scroll_start(device->panel_handle, line);
+ #endif
+ }
+ 
+ /**
+  * @brief Enter or leave partial display mode
+  */
+ esp_err_t st7789_set_partial(st7789_device_t *device, bool enable, uint16_t first_row, uint16_t last_row)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     return esp_lcd_panel_virtual_set_partial(device->panel_handle, enable, first_row, last_row);
+ #else
+     return esp_lcd_st7789t_set_partial(device->panel_handle, enable, first_row, last_row);
+ #endif
+ }
+ 
+ /**
+  * @brief Enter or leave 8-color idle mode
+  */
+ esp_err_t st7789_set_idle_mode(st7789_device_t *device, bool enable)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     return esp_lcd_panel_virtual_set_idle(device->panel_handle, enable);
+ #else
+     return esp_lcd_st7789t_set_idle(device->panel_handle, enable);
+ #endif
+ }
+ 
+ /**
+  * @brief Set the panel refresh rate to the nearest supported value
+  */
+ esp_err_t st7789_set_frame_rate(st7789_device_t *device, uint8_t hz)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     
+     uint8_t rtna = 0;
+     for (uint8_t i = 1; i < sizeof(frame_rate_table); i++) {
+         if (abs(frame_rate_table[i] - hz) < abs(frame_rate_table[rtna] - hz)) {
+             rtna = i;
+         }
+     }
+     
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     esp_err_t ret = ESP_OK;     // Refresh rate has no effect on the frame memory
+ #else
+     esp_err_t ret = esp_lcd_st7789t_set_frame_rate_ctrl(device->panel_handle, rtna);
+ #endif
+     if (ret == ESP_OK) {
+         device->frame_rate_hz = frame_rate_table[rtna];
+         ESP_LOGD(TAG, "Frame rate %d Hz (RTNA 0x%02X)", device->frame_rate_hz, rtna);
+     }
+     return ret;
+ }
+ 
+ /**
+  * @brief Time full-frame pushes at a list of pixel clocks
+  */
+ esp_err_t st7789_pclk_sweep(st7789_device_t *device, const int *pclk_hz, int count, int frames,
+                             st7789_pclk_result_t *results)
+ {
+     if (device == NULL || !device->is_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+     if (pclk_hz == NULL || count <= 0 || frames <= 0 || results == NULL) {
+         return ESP_ERR_INVALID_ARG;
+     }
+     if (device->config.bits_per_pixel != 16) {
+         return ESP_ERR_INVALID_STATE;      // The test pattern is RGB565
+     }
+     
+     int width = device->config.h_res;
+     int height = device->config.v_res;
+     size_t stripe_bytes = (size_t)width * ST7789_SWEEP_STRIPE_LINES * sizeof(uint16_t);
+     uint16_t *stripe[2];
+     stripe[0] = heap_caps_malloc(stripe_bytes, MALLOC_CAP_DMA);
+     stripe[1] = heap_caps_malloc(stripe_bytes, MALLOC_CAP_DMA);
+     if (stripe[0] == NULL || stripe[1] == NULL) {
+         free(stripe[0]);
+         free(stripe[1]);
+         return ESP_ERR_NO_MEM;
+     }
+     // Two colors, so every frame visibly repaints the whole screen
+     pixel_fill565(stripe[0], 0xF800, width * ST7789_SWEEP_STRIPE_LINES);
+     pixel_fill565(stripe[1], 0x001F, width * ST7789_SWEEP_STRIPE_LINES);
+     
+     // The pattern is not the consumer's buffer: keep its done callback quiet,
+     // once the consumer's last transfer has reported done
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     while (esp_lcd_panel_virtual_is_busy(device->panel_handle)) {
+         vTaskDelay(1);
+     }
+ #else
+     esp_err_t drain = esp_lcd_panel_io_tx_param(device->io_handle, LCD_CMD_NOP, NULL, 0);
+     if (drain != ESP_OK) {
+         free(stripe[0]);
+         free(stripe[1]);
+         return drain;
+     }
+ #endif
+     st7789_trans_done_cb_t saved_cb = device->trans_done_cb;
+     void *saved_ctx = device->trans_done_ctx;
+     st7789_register_trans_done_cb(device, NULL, NULL);
+     int saved_pclk = device->config.pixel_clock_hz;
+     
+     esp_err_t ret = ESP_OK;
+     for (int i = 0; i < count && ret == ESP_OK; i++) {
+         ret = st7789_set_pixel_clock(device, pclk_hz[i]);
+         if (ret != ESP_OK) {
+             break;
+         }
+         
+ #if CONFIG_LCD_VIRTUAL_PANEL
+         esp_lcd_panel_virtual_stats_t before, after;
+         esp_lcd_panel_virtual_get_stats(device->panel_handle, &before);
+ #else
+         int64_t start_us = esp_timer_get_time();
+ #endif
+         for (int f = 0; f < frames && ret == ESP_OK; f++) {
+             for (int y = 0; y < height && ret == ESP_OK; y += ST7789_SWEEP_STRIPE_LINES) {
+                 int lines = height - y < ST7789_SWEEP_STRIPE_LINES ? height - y : ST7789_SWEEP_STRIPE_LINES;
+                 ret = esp_lcd_panel_draw_bitmap(device->panel_handle,
+                                                 device->config.offset_x, device->config.offset_y + y,
+                                                 device->config.offset_x + width,
+                                                 device->config.offset_y + y + lines,
+                                                 stripe[f & 1]);
+             }
+         }
+ #if CONFIG_LCD_VIRTUAL_PANEL
+         // Report the modeled bus time, the copy into RAM says nothing about SPI
+         esp_lcd_panel_virtual_get_stats(device->panel_handle, &after);
+         int64_t total_us = (int64_t)(after.bus_time_us - before.bus_time_us);
+ #else
+         // A polling command waits until every queued color transfer is out
+         if (ret == ESP_OK) {
+             ret = esp_lcd_panel_io_tx_param(device->io_handle, LCD_CMD_NOP, NULL, 0);
+         }
+         int64_t total_us = esp_timer_get_time() - start_us;
+ #endif
+         
+         results[i].pclk_hz = pclk_hz[i];
+         results[i].frame_us = (uint32_t)(total_us / frames);
+         results[i].fps_x10 = results[i].frame_us > 0 ? 10000000UL / results[i].frame_us : 0;
+         // Payload rate against the wire rate: what the per-transaction overhead costs
+         uint64_t ideal_us = (uint64_t)width * height * 16 * 1000000ULL / pclk_hz[i];
+         results[i].efficiency_pct = results[i].frame_us > 0 ? (uint8_t)(ideal_us * 100 / results[i].frame_us) : 0;
+         ESP_LOGI(TAG, "  %3d.%02d MHz: %6lu us/frame, %3lu.%lu fps, %3d%% of wire rate",
+                  pclk_hz[i] / 1000000, pclk_hz[i] / 10000 % 100, (unsigned long)results[i].frame_us,
+                  (unsigned long)(results[i].fps_x10 / 10), (unsigned long)(results[i].fps_x10 % 10),
+                  results[i].efficiency_pct);
+     }
+     
+     esp_err_t restore = st7789_set_pixel_clock(device, saved_pclk);
+     st7789_register_trans_done_cb(device, saved_cb, saved_ctx);
+     free(stripe[0]);
+     free(stripe[1]);
+     return ret != ESP_OK ? ret : restore;
+ }
+ 
+ /**
+  * @brief Check if the panel is virtual
+  */
+ bool st7789_is_virtual(st7789_device_t *device)
+ {
+ #if CONFIG_LCD_VIRTUAL_PANEL
+     return device != NULL && device->panel_handle != NULL;
+ #else
+     return false;
+ #endif
+ }
+ 
  /******************************************************************************
   * Backlight Control API Implementation
   ******************************************************************************/
@@ -367,6 +754,110 @@
      return ret;
  }
  
+ /**
+  * @brief Background initialization task, see st7789_init_async()
+  */
+ static void init_task(void *arg)
+ {
+     st7789_device_t *device = (st7789_device_t *)arg;
+     
+     device->init_result = st7789_init(device);
+     xEventGroupSetBits(device->init_events, ST7789_INIT_DONE_BIT);
+     vTaskDelete(NULL);
+ }
+ 
+ /******************************************************************************
+  * Private Functions - Panel IO Callbacks
+  ******************************************************************************/
+ 
+ #if !CONFIG_LCD_VIRTUAL_PANEL
+ /**
+  * @brief Color transfer done trampoline (ISR context)
+  * 
+  * The panel IO is created before any consumer of the pixel buffers
+  * exists, so it always points here and the device forwards the event.
+  */
+ static bool color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+ {
+     st7789_device_t *device = (st7789_device_t *)user_ctx;
+     st7789_trans_done_cb_t callback = device->trans_done_cb;
+     
+     if (callback != NULL) {
+         return callback(device->trans_done_ctx);
+     }
+     return false;
+ }
+ 
+ /**
+  * @brief Create the SPI panel IO at the given pixel clock
+  */
+ static esp_err_t panel_io_create(st7789_device_t *device, int pclk_hz)
+ {
+     esp_lcd_panel_io_spi_config_t io_config = {
+         .dc_gpio_num = device->config.pin_dc,
+         .cs_gpio_num = device->config.pin_cs,
+         .pclk_hz = pclk_hz,
+         .lcd_cmd_bits = ST7789_CMD_BITS,
+         .lcd_param_bits = ST7789_PARAM_BITS,
+         .spi_mode = 0,
+         .trans_queue_depth = 10,
+         .on_color_trans_done = color_trans_done,  // Forwarded to trans_done_cb
+         .user_ctx = device,
+     };
+     
+     return esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)device->config.spi_host, 
+                                     &io_config, 
+                                     &device->io_handle);
+ }
+ #endif
+ 
+ #if CONFIG_LCD_VIRTUAL_PANEL
+ /**
+  * @brief Create the in-memory panel with the geometry and clock of the real one
+  */
+ static esp_err_t virtual_panel_create(st7789_device_t *device)
+ {
+     ESP_LOGI(TAG, "Installing virtual panel (no LCD traffic)");
+     
+     esp_lcd_panel_virtual_config_t virtual_config = {
+         .ram_cols = ST7789_RAM_COLS,
+         .ram_rows = ST7789_RAM_ROWS,
+         .view_x = device->config.offset_x,
+         .view_y = device->config.offset_y,
+         .view_width = device->config.h_res,
+         .view_height = device->config.v_res,
+         .pclk_hz = device->config.pixel_clock_hz,
+         .trans_overhead_us = ST7789_VIRTUAL_TRANS_OVERHEAD_US,
+         .on_color_trans_done = virtual_trans_done,
+         .user_ctx = device,
+         .flags = {
+             .view_mirror_x = 1,     // st7789_init() sets MX for an upright image
+             .pixel_le = 1,          // RAMCTRL in ST7789_Init_Table.h
+ #if CONFIG_LCD_VIRTUAL_PANEL_REALTIME
+             .realtime = 1,
+ #endif
+         },
+     };
+     
+     device->io_handle = NULL;
+     return esp_lcd_new_panel_virtual(&virtual_config, &device->panel_handle);
+ }
+ 
+ /**
+  * @brief Virtual panel transfer done, same forwarding as color_trans_done()
+  */
+ static bool virtual_trans_done(esp_lcd_panel_handle_t panel, void *user_ctx)
+ {
+     st7789_device_t *device = (st7789_device_t *)user_ctx;
+     st7789_trans_done_cb_t callback = device->trans_done_cb;
+     
+     if (callback != NULL) {
+         return callback(device->trans_done_ctx);
+     }
+     return false;
+ }
+ #endif
+ 
  /******************************************************************************
   * Private Functions - Backlight Implementation
   ******************************************************************************/
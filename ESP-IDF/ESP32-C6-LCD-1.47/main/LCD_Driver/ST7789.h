@@ -18,6 +18,7 @@
  #include <stdbool.h>
  #include "freertos/FreeRTOS.h"
  #include "freertos/task.h"
+ #include "freertos/event_groups.h"
  #include "esp_timer.h"
  #include "esp_lcd_panel_io.h"
  #include "esp_lcd_panel_vendor.h"
@@ -29,6 +30,7 @@
  #include "driver/ledc.h"
 
  #include "Vernon_ST7789T.h"
+ #include "Virtual_Panel/Virtual_Panel.h"
 
  /******************************************************************************
   * Hardware Configuration Constants
@@ -38,6 +40,16 @@
  #define ST7789_SPI_HOST             SPI2_HOST
  #define ST7789_PIXEL_CLOCK_HZ       (12 * 1000 * 1000)  // 12MHz
  
+ // Pixel clock sweep: clocks the SPI master can divide exactly from 80MHz
+ #define ST7789_SWEEP_CLOCKS_HZ      { 10000000, 16000000, 20000000, 26666667, 40000000, 80000000 }
+ #define ST7789_SWEEP_STRIPE_LINES   20      // Lines per draw_bitmap while sweeping
+ #define ST7789_SWEEP_FRAMES         10      // Full frames pushed per clock
+ 
+ // Background initialization (st7789_init_async)
+ #define ST7789_INIT_TASK_STACK      3072
+ #define ST7789_INIT_TASK_PRIORITY   5       // Above app_main, the task mostly sleeps
+ #define ST7789_INIT_DONE_BIT        (1 << 0)
+ 
  // GPIO Pin Definitions
  #define ST7789_PIN_SCLK             7
  #define ST7789_PIN_MOSI             6
@@ -56,6 +68,16 @@
  #define ST7789_CMD_BITS             8
  #define ST7789_PARAM_BITS           8
  
+ // Frame memory of the controller (the visible 172x320 sits at ST7789_OFFSET_X)
+ #define ST7789_RAM_COLS             240
+ #define ST7789_RAM_ROWS             320
+ 
+ // Panel refresh rate after init (FRCTRL2 0x0F in the init table)
+ #define ST7789_FRAME_RATE_HZ        60
+ 
+ // Virtual panel bus model (CONFIG_LCD_VIRTUAL_PANEL)
+ #define ST7789_VIRTUAL_TRANS_OVERHEAD_US    8   // SPI master setup per transaction
+ 
  // Backlight PWM Configuration
  #define ST7789_BL_TIMER             LEDC_TIMER_0
  #define ST7789_BL_MODE              LEDC_LOW_SPEED_MODE
@@ -68,6 +90,17 @@
   * Type Definitions - Object-Oriented Structures
   ******************************************************************************/
  
+ /**
+  * @brief Color transfer done callback
+  * 
+  * Called from ISR context when the pixel data of a draw_bitmap call has
+  * been sent, i.e. the color buffer may be reused.
+  * 
+  * @param user_ctx Context registered with the callback
+  * @return true if a higher priority task was woken (yield on ISR exit)
+  */
+ typedef bool (*st7789_trans_done_cb_t)(void *user_ctx);
+ 
  /**
   * @brief Backlight Controller Object
   * 
@@ -110,6 +143,16 @@
      uint8_t initial_brightness;
  } st7789_config_t;
  
+ /**
+  * @brief Result of one pixel clock in st7789_pclk_sweep()
+  */
+ typedef struct {
+     int pclk_hz;                            // Requested pixel clock
+     uint32_t frame_us;                      // Average full-frame push time
+     uint32_t fps_x10;                       // Frames per second x10
+     uint8_t efficiency_pct;                 // Wire-rate time / measured time
+ } st7789_pclk_result_t;
+ 
  /**
   * @brief LCD Device Object
   * 
@@ -120,6 +163,12 @@
      esp_lcd_panel_io_handle_t io_handle;    // Panel IO handle
      st7789_backlight_t backlight;           // Backlight controller
      st7789_config_t config;                 // Configuration
+     int64_t init_time_us;                   // Reset to display on, last st7789_init()
+     st7789_trans_done_cb_t trans_done_cb;   // Color transfer done (ISR context)
+     void *trans_done_ctx;                   // Context for trans_done_cb
+     EventGroupHandle_t init_events;         // ST7789_INIT_DONE_BIT, set by st7789_init_async()
+     esp_err_t init_result;                  // Result of the background st7789_init()
+     uint8_t frame_rate_hz;                  // Panel refresh rate, last st7789_set_frame_rate()
      bool is_initialized;                    // Initialization status
  } st7789_device_t;
  
@@ -150,6 +199,29 @@
   */
  esp_err_t st7789_init(st7789_device_t *device);
  
+ /**
+  * @brief Initialize LCD device in a background task
+  * 
+  * Panel bring-up mostly waits: 120 ms reset recovery and the sleep-out
+  * delay. Running st7789_init() in its own task lets the caller set up
+  * other peripherals meanwhile (the SPI bus is shared safely). The task
+  * sets ST7789_INIT_DONE_BIT in init_events when done; call
+  * st7789_wait_init() before using the device.
+  * 
+  * @param device Pointer to device object
+  * @return ESP_OK if the task was started, error code otherwise
+  */
+ esp_err_t st7789_init_async(st7789_device_t *device);
+ 
+ /**
+  * @brief Wait for st7789_init_async() to finish
+  * 
+  * @param device Pointer to device object
+  * @param timeout_ms Maximum wait (-1 = forever)
+  * @return Result of st7789_init(), ESP_ERR_TIMEOUT if still running
+  */
+ esp_err_t st7789_wait_init(st7789_device_t *device, int timeout_ms);
+ 
  /**
   * @brief Destroy LCD device object and free resources
   * 
@@ -202,6 +274,168 @@
   */
  esp_lcd_panel_handle_t st7789_get_panel_handle(st7789_device_t *device);
  
+ /**
+  * @brief Get window address cache statistics
+  * 
+  * Reports how many CASET/RASET commands (and bytes) the panel driver
+  * skipped because the window was unchanged or the write continued.
+  * 
+  * @param device Pointer to device object
+  * @param stats Output statistics
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_get_window_stats(st7789_device_t *device, esp_lcd_st7789t_window_stats_t *stats);
+ 
+ /**
+  * @brief Register color transfer done callback
+  * 
+  * The panel IO always reports completed color transfers to the device;
+  * this forwards them to the consumer of the pixel buffers (e.g. LVGL
+  * flush ready). May be called before or after st7789_init().
+  * 
+  * @param device Pointer to device object
+  * @param callback Callback function (NULL to unregister)
+  * @param user_ctx Context passed to the callback
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_register_trans_done_cb(st7789_device_t *device, st7789_trans_done_cb_t callback, void *user_ctx);
+ 
+ /**
+  * @brief Change the SPI pixel clock at runtime
+  * 
+  * Re-creates the panel IO at the new clock and hands it to the panel
+  * driver; panel state (init table, MADCTL, window) is kept. Queued color
+  * transfers finish at the old clock first. The caller must keep other
+  * users of the panel (e.g. LVGL: hold lvgl_driver_lock()) out meanwhile.
+  * If the new IO cannot be created the old clock is restored. If that
+  * fails too, no IO is left: the device is marked uninitialized, every
+  * further call fails and only a reboot brings the panel back.
+  * 
+  * The SPI master rounds the clock down to 80MHz / n. Clocks above what
+  * the wiring supports show up as a corrupted image, the panel has no
+  * read-back on this board.
+  * 
+  * @param device Pointer to device object
+  * @param pclk_hz New pixel clock in Hz
+  * @return ESP_OK on success, ESP_ERR_INVALID_STATE if no IO is left (see
+  *         above), other error codes with the old clock still in use
+  */
+ esp_err_t st7789_set_pixel_clock(st7789_device_t *device, int pclk_hz);
+ 
+ /**
+  * @brief Change the color depth of the pixel transfers at runtime
+  * 
+  * 12 bpp (COLMOD 0x53) sends two pixels in three bytes, 25% less than
+  * RGB565, at 4 bits per channel. After the call draw_bitmap expects packed
+  * RGB444 (see pixel_565_to_444()). Frame memory is kept, queued transfers
+  * go out in the old format first. Same locking rules as
+  * st7789_set_pixel_clock().
+  * 
+  * @param device Pointer to device object
+  * @param bits_per_pixel 12 or 16
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_set_color_depth(st7789_device_t *device, uint8_t bits_per_pixel);
+ 
+ /**
+  * @brief Define the hardware vertical scroll area (VSCRDEF)
+  * 
+  * Rows are frame memory rows (ST7789_RAM_ROWS in total), which equal
+  * screen rows + offset_y without rotation. Scrolling moves whole rows,
+  * including the columns outside the visible 172.
+  * 
+  * @param device Pointer to device object
+  * @param top_fixed Rows fixed at the top
+  * @param scroll_lines Rows in the scroll area
+  * @param bottom_fixed Rows fixed at the bottom, the three must add up to ST7789_RAM_ROWS
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_set_scroll_area(st7789_device_t *device, uint16_t top_fixed, uint16_t scroll_lines, uint16_t bottom_fixed);
+ 
+ /**
+  * @brief Set the hardware scroll start address (VSCSAD)
+  * 
+  * The panel shows frame memory row line at the top of the scroll area and
+  * wraps around within it; no pixel data is sent.
+  * 
+  * @param device Pointer to device object
+  * @param line Frame memory row, top_fixed .. top_fixed + scroll_lines - 1
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_set_scroll_start(st7789_device_t *device, uint16_t line);
+ 
+ /**
+  * @brief Enter or leave partial display mode (PTLAR/PTLON, NORON)
+  * 
+  * Only frame memory rows first_row .. last_row are driven, the rest of
+  * the glass is blanked. The image is kept, so leaving partial mode needs
+  * no redraw.
+  * 
+  * @param device Pointer to device object
+  * @param enable true for partial mode, false for normal mode
+  * @param first_row First displayed frame memory row
+  * @param last_row Last displayed frame memory row
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_set_partial(st7789_device_t *device, bool enable, uint16_t first_row, uint16_t last_row);
+ 
+ /**
+  * @brief Enter or leave 8-color idle mode (IDMON/IDMOFF)
+  * 
+  * Each channel is reduced to its MSB; meant for screens that only use
+  * the 8 primary colors, e.g. a status screen in black and white.
+  * 
+  * @param device Pointer to device object
+  * @param enable true for idle mode
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_set_idle_mode(st7789_device_t *device, bool enable);
+ 
+ /**
+  * @brief Set the panel refresh rate (FRCTRL2)
+  * 
+  * Picks the nearest rate the controller supports (39-119 Hz). Lower rates
+  * save driving power on static content at the cost of smoother motion.
+  * 
+  * @param device Pointer to device object
+  * @param hz Requested refresh rate
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_set_frame_rate(st7789_device_t *device, uint8_t hz);
+ 
+ /**
+  * @brief Benchmark full-frame push time at several pixel clocks
+  * 
+  * Pushes frames alternating between two solid colors in
+  * ST7789_SWEEP_STRIPE_LINES stripes at every clock and logs a table.
+  * Watch the panel: the fastest clock with clean frames is the stable
+  * one for this board. The original clock and transfer done callback
+  * are restored afterwards; redraw the screen (e.g. lv_obj_invalidate())
+  * when done. Needs 16 bpp. Same locking rules as st7789_set_pixel_clock().
+  * 
+  * With CONFIG_LCD_VIRTUAL_PANEL the modeled bus time is reported.
+  * 
+  * @param device Pointer to device object
+  * @param pclk_hz Clocks to test (e.g. ST7789_SWEEP_CLOCKS_HZ)
+  * @param count Number of clocks
+  * @param frames Frames per clock
+  * @param results Output, one entry per clock
+  * @return ESP_OK on success, error code otherwise
+  */
+ esp_err_t st7789_pclk_sweep(st7789_device_t *device, const int *pclk_hz, int count, int frames,
+                             st7789_pclk_result_t *results);
+ 
+ /**
+  * @brief Check if the device drives a virtual (in-memory) panel
+  * 
+  * With CONFIG_LCD_VIRTUAL_PANEL the panel handle is an esp_lcd virtual
+  * panel, so the esp_lcd_panel_virtual_* functions can be used on it.
+  * 
+  * @param device Pointer to device object
+  * @return true if the panel is virtual
+  */
+ bool st7789_is_virtual(st7789_device_t *device);
+ 
  /******************************************************************************
   * Backlight Control API
   ******************************************************************************/
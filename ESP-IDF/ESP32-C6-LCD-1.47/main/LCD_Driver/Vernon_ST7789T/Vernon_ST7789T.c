@@ -5,6 +5,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <sys/cdefs.h>
 #include "sdkconfig.h"
 #if CONFIG_LCD_ENABLE_DEBUG_LOG
@@ -22,8 +23,11 @@
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
 
 #include "Vernon_ST7789T/Vernon_ST7789T.h"
+#include "ST7789_Init_Table.h"
 
 static const char *TAG = "lcd_panel.st7789t";
 
@@ -37,6 +41,28 @@ static esp_err_t panel_st7789t_swap_xy(esp_lcd_panel_t *panel, bool swap_axes);
 static esp_err_t panel_st7789t_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap);
 static esp_err_t panel_st7789t_disp_on_off(esp_lcd_panel_t *panel, bool off);
 
+// Frame memory is 240x320, rows are 320 deep unless MV swaps the axes
+#define ST7789T_RAM_COLS    240
+#define ST7789T_RAM_ROWS    320
+// CASET/RASET: 1 command byte + 4 parameter bytes each
+#define ST7789T_WINDOW_CMD_BYTES    5
+// Frame rate control in normal mode, not in esp_lcd_panel_commands.h
+#define ST7789T_CMD_FRCTRL2 0xC6
+// LCM control, not in esp_lcd_panel_commands.h. Its XBGR/XMX/XMY bits are
+// XORed with MADCTL, keep them clear so madctl_val alone sets the orientation
+#define ST7789T_CMD_LCMCTRL 0xC0
+#define ST7789T_LCMCTRL_VAL 0x80
+
+typedef struct {
+    bool valid;         // CASET/RASET registers hold the values below
+    bool cursor_valid;  // address counter sits at the start of next_row
+    int col_start;
+    int col_end;
+    int row_start;
+    int row_end;
+    int next_row;
+} st7789t_window_cache_t;
+
 typedef struct {
     esp_lcd_panel_t base;
     esp_lcd_panel_io_handle_t io;
@@ -47,8 +73,54 @@ typedef struct {
     uint8_t fb_bits_per_pixel;
     uint8_t madctl_val; // save current value of LCD_CMD_MADCTL register
     uint8_t colmod_cal; // save surrent value of LCD_CMD_COLMOD register
+    st7789t_window_cache_t window;      // last programmed window
+    esp_lcd_st7789t_window_stats_t window_stats;
+    int64_t cmd_ready_us;               // earliest time the next command may be sent
 } st7789t_panel_t;
 
+// COLMOD value and bits per pixel in the color buffer for a color depth
+static esp_err_t panel_st7789t_pixel_format(unsigned int bits_per_pixel, uint8_t *colmod, uint8_t *fb_bits_per_pixel)
+{
+    switch (bits_per_pixel) {
+    case 12: // RGB444, two pixels packed into three bytes
+        *colmod = 0x53;
+        *fb_bits_per_pixel = 12;
+        break;
+    case 16: // RGB565
+        *colmod = 0x55;
+        *fb_bits_per_pixel = 16;
+        break;
+    case 18: // RGB666
+        *colmod = 0x66;
+        // each color component (R/G/B) should occupy the 6 high bits of a byte, which means 3 full bytes are required for a pixel
+        *fb_bits_per_pixel = 24;
+        break;
+    default:
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return ESP_OK;
+}
+
+static void panel_st7789t_invalidate_window(st7789t_panel_t *st7789t)
+{
+    memset(&st7789t->window, 0, sizeof(st7789t->window));
+}
+
+// Wait out the remainder of a reset/sleep-out delay. The delay starts when
+// the command is sent, so any work done in between is not waited twice.
+static void panel_st7789t_wait_ready(st7789t_panel_t *st7789t)
+{
+    int64_t wait_us;
+    while ((wait_us = st7789t->cmd_ready_us - esp_timer_get_time()) > 0) {
+        TickType_t ticks = pdMS_TO_TICKS(wait_us / 1000);
+        if (ticks > 0) {
+            vTaskDelay(ticks);
+        } else {
+            esp_rom_delay_us(wait_us);
+        }
+    }
+}
+
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
 {
 #if CONFIG_LCD_ENABLE_DEBUG_LOG
@@ -81,20 +153,8 @@ esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const es
     }
 
     uint8_t fb_bits_per_pixel = 0;
-    switch (panel_dev_config->bits_per_pixel) {
-    case 16: // RGB565
-        st7789t->colmod_cal = 0x55;
-        fb_bits_per_pixel = 16;
-        break;
-    case 18: // RGB666
-        st7789t->colmod_cal = 0x66;
-        // each color component (R/G/B) should occupy the 6 high bits of a byte, which means 3 full bytes are required for a pixel
-        fb_bits_per_pixel = 24;
-        break;
-    default:
-        ESP_GOTO_ON_FALSE(false, ESP_ERR_NOT_SUPPORTED, err, TAG, "unsupported pixel width");
-        break;
-    }
+    ESP_GOTO_ON_ERROR(panel_st7789t_pixel_format(panel_dev_config->bits_per_pixel, &st7789t->colmod_cal, &fb_bits_per_pixel),
+                      err, TAG, "unsupported pixel width");
 
     st7789t->io = io;
     st7789t->fb_bits_per_pixel = fb_bits_per_pixel;
@@ -139,17 +199,18 @@ static esp_err_t panel_st7789t_reset(esp_lcd_panel_t *panel)
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    panel_st7789t_invalidate_window(st7789t);
 
     // perform hardware reset
     if (st7789t->reset_gpio_num >= 0) {
         gpio_set_level(st7789t->reset_gpio_num, st7789t->reset_level);
-        vTaskDelay(pdMS_TO_TICKS(10));
+        esp_rom_delay_us(ST7789_RESET_PULSE_MS * 1000);
         gpio_set_level(st7789t->reset_gpio_num, !st7789t->reset_level);
-        vTaskDelay(pdMS_TO_TICKS(10));
     } else { // perform software reset
         esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, NULL, 0);
-        vTaskDelay(pdMS_TO_TICKS(20)); // spec, wait at least 5m before sending new command
     }
+    // don't block here, init() waits for whatever is left of the recovery time
+    st7789t->cmd_ready_us = esp_timer_get_time() + ST7789_RESET_RECOVERY_MS * 1000;
 
     return ESP_OK;
 }
@@ -158,44 +219,30 @@ static esp_err_t panel_st7789t_init(esp_lcd_panel_t *panel)
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
-    // LCD goes into sleep mode and display will be turned off after power on reset, exit sleep mode first
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    /* Memory Data Access Control, MX=MV=1, MY=ML=MH=0, RGB=0 */
-    esp_lcd_panel_io_tx_param(io, 0x36, (uint8_t []){0x00}, 1);                           // 0x36: 接口像素格式 X镜像，Y镜像
-    /* Interface Pixel Format, 16bits/pixel for RGB/MCU interface */
-    esp_lcd_panel_io_tx_param(io, 0x3A, (uint8_t []){0x55}, 1);                           // 0x3A: Porch 设置
-    
-    esp_lcd_panel_io_tx_param(io, 0xB0, (uint8_t []){0x00, 0xE8}, 2);   
-    /* Porch Setting */
-    esp_lcd_panel_io_tx_param(io, 0xB2, (uint8_t []){0x0c, 0x0c, 0x00, 0x33, 0x33}, 5);      
-    /* Gate Control, Vgh=13.65V, Vgl=-10.43V */
-    esp_lcd_panel_io_tx_param(io, 0xB7, (uint8_t []){0x75}, 1);
-    /* VCOM Setting, VCOM=1.175V */
-    esp_lcd_panel_io_tx_param(io, 0xBB, (uint8_t []){0x1A}, 1);
-    /* LCM Control, XOR: BGR, MX, MH */
-    esp_lcd_panel_io_tx_param(io, 0xC0, (uint8_t []){0x80}, 1);
-    /* VDV and VRH Command Enable, enable=1 */
-    esp_lcd_panel_io_tx_param(io, 0xC2, (uint8_t []){0x01, 0xff}, 2);
-    /* VRH Set, Vap=4.4+... */
-    esp_lcd_panel_io_tx_param(io, 0xC3, (uint8_t []){0x13}, 1);
-    /* VDV Set, VDV=0 */
-    esp_lcd_panel_io_tx_param(io, 0xC4, (uint8_t []){0x20}, 1);
-    /* Frame Rate Control, 60Hz, inversion=0 */
-    esp_lcd_panel_io_tx_param(io, 0xC6, (uint8_t []){0x0F}, 1);
-    /* Power Control 1, AVDD=6.8V, AVCL=-4.8V, VDDS=2.3V */
-    esp_lcd_panel_io_tx_param(io, 0xD0, (uint8_t []){0xA4, 0xA1}, 1);
-    /* Positive Voltage Gamma Control */
-    esp_lcd_panel_io_tx_param(io, 0xE0, (uint8_t []){0xD0, 0x0D, 0x14, 0x0D, 0x0D, 0x09, 0x38, 0x44, 0x4E, 0x3A, 0x17, 0x18, 0x2F, 0x30}, 14);
-    /* Negative Voltage Gamma Control */
-    esp_lcd_panel_io_tx_param(io, 0xE1, (uint8_t []){0xD0, 0x09, 0x0F, 0x08, 0x07, 0x14, 0x37, 0x44, 0x4D, 0x38, 0x15, 0x16, 0x2C, 0x2E}, 14);
-    /* Sleep Out */
-    esp_lcd_panel_io_tx_param(io, 0x21, NULL, 0);
-    /* Display On */
-    esp_lcd_panel_io_tx_param(io, 0x29, NULL, 0);
-
-    esp_lcd_panel_io_tx_param(io, 0x2C, NULL, 0);
+    panel_st7789t_invalidate_window(st7789t);
+
+    // LCD goes into sleep mode and display will be turned off after power on reset,
+    // the shared table exits sleep mode first
+    for (size_t i = 0; i < ST7789_INIT_TABLE_SIZE; i++) {
+        const st7789_init_cmd_t *init_cmd = &st7789_init_table[i];
+        panel_st7789t_wait_ready(st7789t);
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, init_cmd->cmd, init_cmd->data,
+                            init_cmd->data_bytes & ST7789_INIT_LEN_MASK), TAG, "send command 0x%02X failed", init_cmd->cmd);
+        if (init_cmd->data_bytes & ST7789_INIT_DELAY) {
+            st7789t->cmd_ready_us = esp_timer_get_time() + init_cmd->delay_ms * 1000;
+        }
+    }
+    panel_st7789t_wait_ready(st7789t);
+
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, ST7789T_CMD_LCMCTRL, (uint8_t[]) {
+        ST7789T_LCMCTRL_VAL,
+    }, 1), TAG, "send command failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
+        st7789t->madctl_val,
+    }, 1), TAG, "send command failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_COLMOD, (uint8_t[]) {
+        st7789t->colmod_cal,
+    }, 1), TAG, "send command failed");
 
     return ESP_OK;
 }
@@ -205,30 +252,71 @@ static esp_err_t panel_st7789t_draw_bitmap(esp_lcd_panel_t *panel, int x_start,
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    ESP_RETURN_ON_FALSE(io, ESP_ERR_INVALID_STATE, TAG, "panel IO detached");
+    esp_err_t ret = ESP_OK;
 
     x_start += st7789t->x_gap;
     x_end += st7789t->x_gap;
     y_start += st7789t->y_gap;
     y_end += st7789t->y_gap;
 
-    // define an area of frame memory where MCU can access
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
-        (x_start >> 8) & 0xFF,
-        x_start & 0xFF,
-        ((x_end - 1) >> 8) & 0xFF,
-        (x_end - 1) & 0xFF,
-    }, 4);
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
-        (y_start >> 8) & 0xFF,
-        y_start & 0xFF,
-        ((y_end - 1) >> 8) & 0xFF,
-        (y_end - 1) & 0xFF,
-    }, 4);
-    // transfer frame buffer
-    size_t len = (x_end - x_start) * (y_end - y_start) * st7789t->fb_bits_per_pixel / 8;
-    esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len);
+    // Only send the parts of the window that changed. RASET is programmed
+    // open-ended so a following area that starts on the next row with the
+    // same columns can simply continue the memory write.
+    st7789t_window_cache_t *win = &st7789t->window;
+    esp_lcd_st7789t_window_stats_t *stats = &st7789t->window_stats;
+    int row_max = ((st7789t->madctl_val & LCD_CMD_MV_BIT) ? ST7789T_RAM_COLS : ST7789T_RAM_ROWS) - 1;
+    bool same_cols = win->valid && win->col_start == x_start && win->col_end == x_end - 1;
+    int ramwr_cmd = LCD_CMD_RAMWR;
+
+    stats->windows++;
+    if (same_cols && win->cursor_valid && win->next_row == y_start && y_end - 1 <= win->row_end) {
+        ramwr_cmd = LCD_CMD_WRMEMC;
+        stats->continued++;
+        stats->bytes_saved += 2 * ST7789T_WINDOW_CMD_BYTES;
+    } else {
+        if (same_cols) {
+            stats->caset_skipped++;
+            stats->bytes_saved += ST7789T_WINDOW_CMD_BYTES;
+        } else {
+            // define an area of frame memory where MCU can access
+            ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
+                (x_start >> 8) & 0xFF,
+                x_start & 0xFF,
+                ((x_end - 1) >> 8) & 0xFF,
+                (x_end - 1) & 0xFF,
+            }, 4), err, TAG, "send CASET failed");
+            win->col_start = x_start;
+            win->col_end = x_end - 1;
+        }
+        if (win->valid && win->row_start == y_start && win->row_end == row_max) {
+            stats->raset_skipped++;
+            stats->bytes_saved += ST7789T_WINDOW_CMD_BYTES;
+        } else {
+            ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
+                (y_start >> 8) & 0xFF,
+                y_start & 0xFF,
+                (row_max >> 8) & 0xFF,
+                row_max & 0xFF,
+            }, 4), err, TAG, "send RASET failed");
+            win->row_start = y_start;
+            win->row_end = row_max;
+        }
+        win->valid = true;
+    }
+    win->cursor_valid = true;
+    win->next_row = y_end;
+
+    // transfer frame buffer, an odd RGB444 pixel count ends on half a byte
+    size_t len = ((x_end - x_start) * (y_end - y_start) * st7789t->fb_bits_per_pixel + 7) / 8;
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_color(io, ramwr_cmd, color_data, len), err, TAG, "send pixels failed");
 
     return ESP_OK;
+err:
+    // What reached the panel is unknown, send the full window next time
+    win->valid = false;
+    win->cursor_valid = false;
+    return ret;
 }
 
 static esp_err_t panel_st7789t_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
@@ -236,6 +324,7 @@ static esp_err_t panel_st7789t_invert_color(esp_lcd_panel_t *panel, bool invert_
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
     int command = 0;
+    st7789t->window.cursor_valid = false;
     if (invert_color_data) {
         command = LCD_CMD_INVON;
     } else {
@@ -249,6 +338,7 @@ static esp_err_t panel_st7789t_mirror(esp_lcd_panel_t *panel, bool mirror_x, boo
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    panel_st7789t_invalidate_window(st7789t);
     if (mirror_x) {
         st7789t->madctl_val |= LCD_CMD_MX_BIT;
     } else {
@@ -269,6 +359,7 @@ static esp_err_t panel_st7789t_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    panel_st7789t_invalidate_window(st7789t);
     if (swap_axes) {
         st7789t->madctl_val |= LCD_CMD_MV_BIT;
     } else {
@@ -285,6 +376,122 @@ static esp_err_t panel_st7789t_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     st7789t->x_gap = x_gap;
     st7789t->y_gap = y_gap;
+    panel_st7789t_invalidate_window(st7789t);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_get_window_stats(esp_lcd_panel_handle_t panel, esp_lcd_st7789t_window_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(panel && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    *stats = st7789t->window_stats;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_reset_window_stats(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    memset(&st7789t->window_stats, 0, sizeof(st7789t->window_stats));
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_set_io(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    st7789t->io = io;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_set_bits_per_pixel(esp_lcd_panel_handle_t panel, unsigned int bits_per_pixel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    uint8_t colmod = 0;
+    uint8_t fb_bits_per_pixel = 0;
+    ESP_RETURN_ON_ERROR(panel_st7789t_pixel_format(bits_per_pixel, &colmod, &fb_bits_per_pixel),
+                        TAG, "unsupported pixel width");
+
+    // waits for queued color transfers, they still go out in the old format
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(st7789t->io, LCD_CMD_COLMOD, (uint8_t[]) {
+        colmod,
+    }, 1), TAG, "send command failed");
+    st7789t->colmod_cal = colmod;
+    st7789t->fb_bits_per_pixel = fb_bits_per_pixel;
+    st7789t->window.cursor_valid = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_set_scroll_area(esp_lcd_panel_handle_t panel, int top_fixed, int scroll_lines, int bottom_fixed)
+{
+    ESP_RETURN_ON_FALSE(panel && top_fixed >= 0 && scroll_lines >= 0 && bottom_fixed >= 0 &&
+                        top_fixed + scroll_lines + bottom_fixed == ST7789T_RAM_ROWS,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    st7789t->window.cursor_valid = false;
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(st7789t->io, LCD_CMD_VSCRDEF, (uint8_t[]) {
+        (top_fixed >> 8) & 0xFF,
+        top_fixed & 0xFF,
+        (scroll_lines >> 8) & 0xFF,
+        scroll_lines & 0xFF,
+        (bottom_fixed >> 8) & 0xFF,
+        bottom_fixed & 0xFF,
+    }, 6), TAG, "send command failed");
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_set_scroll_start(esp_lcd_panel_handle_t panel, int line)
+{
+    ESP_RETURN_ON_FALSE(panel && line >= 0 && line < ST7789T_RAM_ROWS, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    st7789t->window.cursor_valid = false;
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(st7789t->io, LCD_CMD_VSCSAD, (uint8_t[]) {
+        (line >> 8) & 0xFF,
+        line & 0xFF,
+    }, 2), TAG, "send command failed");
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_set_partial(esp_lcd_panel_handle_t panel, bool enable, int start_line, int end_line)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789t->io;
+
+    if (!enable) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_NORON, NULL, 0), TAG, "send command failed");
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(start_line >= 0 && start_line < ST7789T_RAM_ROWS &&
+                        end_line >= 0 && end_line < ST7789T_RAM_ROWS,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_PTLAR, (uint8_t[]) {
+        (start_line >> 8) & 0xFF,
+        start_line & 0xFF,
+        (end_line >> 8) & 0xFF,
+        end_line & 0xFF,
+    }, 4), TAG, "send command failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_PTLON, NULL, 0), TAG, "send command failed");
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_set_idle(esp_lcd_panel_handle_t panel, bool enable)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(st7789t->io, enable ? LCD_CMD_IDMON : LCD_CMD_IDMOFF, NULL, 0),
+                        TAG, "send command failed");
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7789t_set_frame_rate_ctrl(esp_lcd_panel_handle_t panel, uint8_t frctrl2)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(st7789t->io, ST7789T_CMD_FRCTRL2, (uint8_t[]) {
+        frctrl2,
+    }, 1), TAG, "send command failed");
     return ESP_OK;
 }
 
@@ -293,6 +500,7 @@ static esp_err_t panel_st7789t_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
     int command = 0;
+    st7789t->window.cursor_valid = false;
     if (on_off) {
         command = LCD_CMD_DISPON;
     } else {
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "esp_lcd_types.h"
 
@@ -22,13 +23,28 @@ typedef struct {
         lcd_color_rgb_endian_t color_space; /*!< @deprecated Set RGB color space, please use rgb_endian instead */
         lcd_color_rgb_endian_t rgb_endian;  /*!< Set RGB data endian: RGB or BGR */
     };
-    unsigned int bits_per_pixel;       /*!< Color depth, in bpp */
+    unsigned int bits_per_pixel;       /*!< Color depth, in bpp: 12 (packed RGB444), 16 or 18 */
     struct {
         unsigned int reset_active_high: 1; /*!< Setting this if the panel reset is high level active */
     } flags;                               /*!< LCD panel config flags */
     void *vendor_config; /*!< vendor specific configuration, optional, left as NULL if not used */
 } esp_lcd_panel_dev_st7789t_config_t;
 
+/**
+ * @brief Window address cache statistics
+ *
+ * The panel driver remembers the last programmed window and skips CASET/RASET
+ * when they are unchanged, or continues the memory write (RAMWRC) when the
+ * next area starts right below the previous one.
+ */
+typedef struct {
+    uint32_t windows;       /*!< Number of draw_bitmap window setups */
+    uint32_t caset_skipped; /*!< CASET commands skipped (unchanged columns) */
+    uint32_t raset_skipped; /*!< RASET commands skipped (unchanged rows) */
+    uint32_t continued;     /*!< Draws continued with RAMWRC instead of a new window */
+    uint32_t bytes_saved;   /*!< Command + parameter bytes not sent */
+} esp_lcd_st7789t_window_stats_t;
+
 /**
  * @brief Create LCD panel for model ST7789T
  *
@@ -42,6 +58,129 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Get window address cache statistics
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[out] stats Returned statistics
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_get_window_stats(esp_lcd_panel_handle_t panel, esp_lcd_st7789t_window_stats_t *stats);
+
+/**
+ * @brief Reset window address cache statistics
+ *
+ * @param[in] panel ST7789T panel handle
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_reset_window_stats(esp_lcd_panel_handle_t panel);
+
+/**
+ * @brief Change the color depth at runtime (COLMOD)
+ *
+ * Later draw_bitmap calls must pass color data in the new format: for 12 bpp
+ * two pixels packed into three bytes (R0G0 B0R1 G1B1). Frame memory is not
+ * touched, the image on screen stays.
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[in] bits_per_pixel 12, 16 or 18
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NOT_SUPPORTED if the color depth is not supported
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_set_bits_per_pixel(esp_lcd_panel_handle_t panel, unsigned int bits_per_pixel);
+
+/**
+ * @brief Define the vertical scroll area (VSCRDEF)
+ *
+ * Splits the 320 frame memory rows into a fixed top, a scrolling middle and
+ * a fixed bottom. Scrolling moves whole frame memory rows, so it is vertical
+ * on screen only without MADCTL MV.
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[in] top_fixed Rows fixed at the top
+ * @param[in] scroll_lines Rows in the scroll area
+ * @param[in] bottom_fixed Rows fixed at the bottom, the three must add up to 320
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_set_scroll_area(esp_lcd_panel_handle_t panel, int top_fixed, int scroll_lines, int bottom_fixed);
+
+/**
+ * @brief Set the vertical scroll start address (VSCSAD)
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[in] line Frame memory row shown at the top of the scroll area
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_set_scroll_start(esp_lcd_panel_handle_t panel, int line);
+
+/**
+ * @brief Enter partial mode (PTLAR + PTLON) or go back to normal mode (NORON)
+ *
+ * In partial mode only the lines start_line .. end_line are driven, the
+ * rest of the glass is blanked. Frame memory is kept, so normal mode shows
+ * the full image again without a redraw.
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[in] enable true for partial mode, false for normal mode
+ * @param[in] start_line First displayed frame memory row
+ * @param[in] end_line Last displayed frame memory row (ignored for normal mode)
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_set_partial(esp_lcd_panel_handle_t panel, bool enable, int start_line, int end_line);
+
+/**
+ * @brief Switch 8-color idle mode (IDMON/IDMOFF)
+ *
+ * Idle mode shows only the MSB of each color channel.
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[in] enable true for idle mode
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_set_idle(esp_lcd_panel_handle_t panel, bool enable);
+
+/**
+ * @brief Write the normal mode frame rate control register (FRCTRL2, 0xC6)
+ *
+ * Bits 4:0 (RTNA) select the rate, 0x00 = 119 Hz, 0x0F = 60 Hz, 0x1F = 39 Hz.
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[in] frctrl2 Register value
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_set_frame_rate_ctrl(esp_lcd_panel_handle_t panel, uint8_t frctrl2);
+
+/**
+ * @brief Replace the panel IO, e.g. after re-creating it at another clock
+ *
+ * The panel keeps its state; no command is sent. The old IO must be idle.
+ * NULL detaches the IO before it is deleted; panel calls fail until a new
+ * IO is set.
+ *
+ * @param[in] panel ST7789T panel handle
+ * @param[in] io New LCD panel IO handle, or NULL
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7789t_set_io(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,490 @@
+/*
+ * Virtual LCD panel: an esp_lcd panel backed by an in-memory frame buffer
+ *
+ * Pixel data is decoded the way an ST7789 receives it on the wire: the
+ * first byte of every RGB565 pixel is the high byte, unless RAMCTRL selects
+ * little endian (flags.pixel_le). MADCTL MV/MX/MY (swap_xy and
+ * mirror) change where a write lands in frame memory, exactly like the
+ * controller's address counter. Each draw_bitmap is modeled as the
+ * transactions the ST7789T driver would send: CASET, RASET and RAMWR with
+ * the pixel data. In realtime mode reset and init also take as long as on
+ * the ST7789: the reset recovery time and the delays in the shared init
+ * table, so boot timings include the panel bring-up.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "sdkconfig.h"
+#include "esp_lcd_panel_interface.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "Virtual_Panel/Virtual_Panel.h"
+#include "ST7789_Init_Table.h"
+
+static const char *TAG = "lcd_panel.virtual";
+
+static esp_err_t panel_virtual_del(esp_lcd_panel_t *panel);
+static esp_err_t panel_virtual_reset(esp_lcd_panel_t *panel);
+static esp_err_t panel_virtual_init(esp_lcd_panel_t *panel);
+static esp_err_t panel_virtual_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data);
+static esp_err_t panel_virtual_invert_color(esp_lcd_panel_t *panel, bool invert_color_data);
+static esp_err_t panel_virtual_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y);
+static esp_err_t panel_virtual_swap_xy(esp_lcd_panel_t *panel, bool swap_axes);
+static esp_err_t panel_virtual_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap);
+static esp_err_t panel_virtual_disp_on_off(esp_lcd_panel_t *panel, bool on_off);
+static void panel_virtual_done_timer_cb(void *arg);
+
+// CASET/RASET: 1 command byte + 4 parameter bytes each, RAMWR: 1 command byte
+#define VIRTUAL_WINDOW_CMD_BYTES    5
+#define VIRTUAL_RAMWR_CMD_BYTES     1
+
+typedef struct {
+    esp_lcd_panel_t base;
+    esp_lcd_panel_virtual_config_t config;
+    uint16_t *frame;                    // ram_cols x ram_rows, CPU byte order
+    int x_gap;
+    int y_gap;
+    uint8_t madctl_val;                 // only MV/MX/MY are modeled
+    uint8_t bits_per_pixel;             // 16 (RGB565) or 12 (packed RGB444)
+    int scroll_top;                     // VSCRDEF top fixed rows
+    int scroll_lines;                   // VSCRDEF scroll area rows
+    int scroll_start;                   // VSCSAD
+    bool partial;                       // PTLON, lines outside partial_start..partial_end are blank
+    int partial_start;
+    int partial_end;
+    bool idle;                          // IDMON, 8 colors
+    esp_lcd_panel_virtual_stats_t stats;
+    esp_timer_handle_t done_timer;      // realtime mode: fires when the modeled transfer ends
+    uint32_t done_pending;              // Draws whose done callback has not run yet (atomic)
+    int64_t bus_free_us;                // realtime mode: end of the last modeled transfer
+    int64_t cmd_ready_us;               // realtime mode: end of the reset/sleep-out delay
+} virtual_panel_t;
+
+esp_err_t esp_lcd_new_panel_virtual(const esp_lcd_panel_virtual_config_t *config, esp_lcd_panel_handle_t *ret_panel)
+{
+    esp_err_t ret = ESP_OK;
+    virtual_panel_t *virt = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_panel && config->ram_cols > 0 && config->ram_rows > 0 && config->pclk_hz > 0,
+                      ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->view_x >= 0 && config->view_y >= 0 &&
+                      config->view_x + config->view_width <= config->ram_cols &&
+                      config->view_y + config->view_height <= config->ram_rows,
+                      ESP_ERR_INVALID_ARG, err, TAG, "visible area outside frame memory");
+    virt = calloc(1, sizeof(virtual_panel_t));
+    ESP_GOTO_ON_FALSE(virt, ESP_ERR_NO_MEM, err, TAG, "no mem for virtual panel");
+    virt->frame = calloc((size_t)config->ram_cols * config->ram_rows, sizeof(uint16_t));
+    ESP_GOTO_ON_FALSE(virt->frame, ESP_ERR_NO_MEM, err, TAG, "no mem for frame memory");
+
+    if (config->flags.realtime) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = panel_virtual_done_timer_cb,
+            .arg = virt,
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+            .dispatch_method = ESP_TIMER_ISR,
+#else
+            .dispatch_method = ESP_TIMER_TASK,
+#endif
+            .name = "lcd_virtual",
+        };
+        ESP_GOTO_ON_ERROR(esp_timer_create(&timer_args, &virt->done_timer), err, TAG, "create done timer failed");
+    }
+
+    memcpy(&virt->config, config, sizeof(esp_lcd_panel_virtual_config_t));
+    virt->bits_per_pixel = 16;
+    virt->scroll_lines = config->ram_rows;
+    virt->base.del = panel_virtual_del;
+    virt->base.reset = panel_virtual_reset;
+    virt->base.init = panel_virtual_init;
+    virt->base.draw_bitmap = panel_virtual_draw_bitmap;
+    virt->base.invert_color = panel_virtual_invert_color;
+    virt->base.set_gap = panel_virtual_set_gap;
+    virt->base.mirror = panel_virtual_mirror;
+    virt->base.swap_xy = panel_virtual_swap_xy;
+    virt->base.disp_on_off = panel_virtual_disp_on_off;
+    *ret_panel = &(virt->base);
+    ESP_LOGI(TAG, "virtual panel %dx%d @ %d Hz%s", config->ram_cols, config->ram_rows,
+             config->pclk_hz, config->flags.realtime ? " (realtime)" : "");
+    return ESP_OK;
+
+err:
+    if (virt) {
+        free(virt->frame);
+        free(virt);
+    }
+    return ret;
+}
+
+static esp_err_t panel_virtual_del(esp_lcd_panel_t *panel)
+{
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+
+    if (virt->done_timer) {
+        esp_timer_stop(virt->done_timer);
+        esp_timer_delete(virt->done_timer);
+    }
+    free(virt->frame);
+    free(virt);
+    return ESP_OK;
+}
+
+static esp_err_t panel_virtual_reset(esp_lcd_panel_t *panel)
+{
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    virt->madctl_val = 0;
+    virt->bits_per_pixel = 16;
+    virt->scroll_top = 0;
+    virt->scroll_lines = virt->config.ram_rows;
+    virt->scroll_start = 0;
+    virt->partial = false;
+    virt->idle = false;
+    memset(virt->frame, 0, (size_t)virt->config.ram_cols * virt->config.ram_rows * sizeof(uint16_t));
+    if (virt->config.flags.realtime) {
+        // Like the ST7789T driver: don't block, init() waits for the recovery time
+        virt->cmd_ready_us = esp_timer_get_time() + ST7789_RESET_RECOVERY_MS * 1000;
+    }
+    return ESP_OK;
+}
+
+// Wait out the remainder of a modeled reset/sleep-out delay
+static void panel_virtual_wait_ready(virtual_panel_t *virt)
+{
+    int64_t wait_us;
+    while ((wait_us = virt->cmd_ready_us - esp_timer_get_time()) > 0) {
+        TickType_t ticks = pdMS_TO_TICKS(wait_us / 1000);
+        if (ticks > 0) {
+            vTaskDelay(ticks);
+        } else {
+            esp_rom_delay_us(wait_us);
+        }
+    }
+}
+
+static esp_err_t panel_virtual_init(esp_lcd_panel_t *panel)
+{
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+
+    if (!virt->config.flags.realtime) {
+        return ESP_OK;
+    }
+    // Only the delays of the init table are modeled, its few bytes of bus time are not
+    for (size_t i = 0; i < ST7789_INIT_TABLE_SIZE; i++) {
+        panel_virtual_wait_ready(virt);
+        if (st7789_init_table[i].data_bytes & ST7789_INIT_DELAY) {
+            virt->cmd_ready_us = esp_timer_get_time() + st7789_init_table[i].delay_ms * 1000;
+        }
+    }
+    panel_virtual_wait_ready(virt);
+    return ESP_OK;
+}
+
+static void panel_virtual_notify_done(virtual_panel_t *virt)
+{
+    __atomic_sub_fetch(&virt->done_pending, 1, __ATOMIC_ACQ_REL);
+    if (virt->config.on_color_trans_done) {
+        virt->config.on_color_trans_done(&virt->base, virt->config.user_ctx);
+    }
+}
+
+static void panel_virtual_done_timer_cb(void *arg)
+{
+    panel_virtual_notify_done((virtual_panel_t *)arg);
+}
+
+// Pixel i of a color buffer as RGB565, RGB444 is widened like the controller does
+static uint16_t panel_virtual_read_pixel(const virtual_panel_t *virt, const uint8_t *src, size_t i)
+{
+    if (virt->bits_per_pixel == 12) {
+        const uint8_t *p = src + i * 3 / 2;
+        uint32_t r, g, b;
+        if (i & 1) {
+            r = p[0] & 0x0F;
+            g = p[1] >> 4;
+            b = p[1] & 0x0F;
+        } else {
+            r = p[0] >> 4;
+            g = p[0] & 0x0F;
+            b = p[1] >> 4;
+        }
+        return (uint16_t)((((r << 1) | (r >> 3)) << 11) | (((g << 2) | (g >> 2)) << 5) | ((b << 1) | (b >> 3)));
+    }
+    src += i * 2;
+    return virt->config.flags.pixel_le ? (uint16_t)(src[0] | (src[1] << 8)) : (uint16_t)((src[0] << 8) | src[1]);
+}
+
+static esp_err_t panel_virtual_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
+    const esp_lcd_panel_virtual_config_t *cfg = &virt->config;
+    const uint8_t *src = (const uint8_t *)color_data;
+
+    x_start += virt->x_gap;
+    x_end += virt->x_gap;
+    y_start += virt->y_gap;
+    y_end += virt->y_gap;
+
+    // Store the pixels where the controller's address counter would put them
+    bool mv = virt->madctl_val & LCD_CMD_MV_BIT;
+    bool mx = virt->madctl_val & LCD_CMD_MX_BIT;
+    bool my = virt->madctl_val & LCD_CMD_MY_BIT;
+    size_t i = 0;
+    for (int y = y_start; y < y_end; y++) {
+        for (int x = x_start; x < x_end; x++, i++) {
+            int col = mv ? y : x;
+            int row = mv ? x : y;
+            if (mx) {
+                col = cfg->ram_cols - 1 - col;
+            }
+            if (my) {
+                row = cfg->ram_rows - 1 - row;
+            }
+            if (col >= 0 && col < cfg->ram_cols && row >= 0 && row < cfg->ram_rows) {
+                virt->frame[row * cfg->ram_cols + col] = panel_virtual_read_pixel(virt, src, i);
+            }
+        }
+    }
+
+    // Model the bus: CASET + RASET + RAMWR/pixels, each its own transaction
+    uint32_t pixel_bytes = ((uint32_t)(x_end - x_start) * (y_end - y_start) * virt->bits_per_pixel + 7) / 8;
+    uint32_t cmd_bytes = 2 * VIRTUAL_WINDOW_CMD_BYTES + VIRTUAL_RAMWR_CMD_BYTES;
+    uint32_t cost_us = 3 * cfg->trans_overhead_us +
+                       (uint32_t)(((uint64_t)(cmd_bytes + pixel_bytes) * 8 * 1000000 + cfg->pclk_hz - 1) / cfg->pclk_hz);
+    virt->stats.draws++;
+    virt->stats.transactions += 3;
+    virt->stats.cmd_bytes += cmd_bytes;
+    virt->stats.pixel_bytes += pixel_bytes;
+    virt->stats.bus_time_us += cost_us;
+
+    if (!cfg->flags.realtime) {
+        __atomic_add_fetch(&virt->done_pending, 1, __ATOMIC_ACQ_REL);
+        panel_virtual_notify_done(virt);
+        return ESP_OK;
+    }
+
+    // Realtime: the buffer is released when the modeled transfer would end.
+    // Callers normally wait for it, one still pending is completed early.
+    // If the timer can no longer be stopped its callback is already on the
+    // way and reports that transfer itself.
+    if (__atomic_load_n(&virt->done_pending, __ATOMIC_ACQUIRE) != 0 &&
+        esp_timer_stop(virt->done_timer) == ESP_OK) {
+        panel_virtual_notify_done(virt);
+    }
+    int64_t now = esp_timer_get_time();
+    int64_t start = virt->bus_free_us > now ? virt->bus_free_us : now;
+    virt->bus_free_us = start + cost_us;
+    __atomic_add_fetch(&virt->done_pending, 1, __ATOMIC_ACQ_REL);
+    esp_timer_start_once(virt->done_timer, virt->bus_free_us - now);
+    return ESP_OK;
+}
+
+static esp_err_t panel_virtual_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
+{
+    return ESP_OK;
+}
+
+static esp_err_t panel_virtual_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y)
+{
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    if (mirror_x) {
+        virt->madctl_val |= LCD_CMD_MX_BIT;
+    } else {
+        virt->madctl_val &= ~LCD_CMD_MX_BIT;
+    }
+    if (mirror_y) {
+        virt->madctl_val |= LCD_CMD_MY_BIT;
+    } else {
+        virt->madctl_val &= ~LCD_CMD_MY_BIT;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t panel_virtual_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
+{
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    if (swap_axes) {
+        virt->madctl_val |= LCD_CMD_MV_BIT;
+    } else {
+        virt->madctl_val &= ~LCD_CMD_MV_BIT;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t panel_virtual_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
+{
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    virt->x_gap = x_gap;
+    virt->y_gap = y_gap;
+    return ESP_OK;
+}
+
+static esp_err_t panel_virtual_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_get_stats(esp_lcd_panel_handle_t panel, esp_lcd_panel_virtual_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(panel && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    *stats = virt->stats;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_reset_stats(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    memset(&virt->stats, 0, sizeof(virt->stats));
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_set_pclk(esp_lcd_panel_handle_t panel, int pclk_hz)
+{
+    ESP_RETURN_ON_FALSE(panel && pclk_hz > 0, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    virt->config.pclk_hz = pclk_hz;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_set_bits_per_pixel(esp_lcd_panel_handle_t panel, unsigned int bits_per_pixel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(bits_per_pixel == 12 || bits_per_pixel == 16, ESP_ERR_NOT_SUPPORTED, TAG, "unsupported pixel width");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    virt->bits_per_pixel = bits_per_pixel;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_set_scroll_area(esp_lcd_panel_handle_t panel, int top_fixed, int scroll_lines, int bottom_fixed)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    ESP_RETURN_ON_FALSE(top_fixed >= 0 && scroll_lines >= 0 && bottom_fixed >= 0 &&
+                        top_fixed + scroll_lines + bottom_fixed == virt->config.ram_rows,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virt->scroll_top = top_fixed;
+    virt->scroll_lines = scroll_lines;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_set_scroll_start(esp_lcd_panel_handle_t panel, int line)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    ESP_RETURN_ON_FALSE(line >= 0 && line < virt->config.ram_rows, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virt->scroll_start = line;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_set_partial(esp_lcd_panel_handle_t panel, bool enable, int start_line, int end_line)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    if (enable) {
+        ESP_RETURN_ON_FALSE(start_line >= 0 && start_line < virt->config.ram_rows &&
+                            end_line >= 0 && end_line < virt->config.ram_rows,
+                            ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+        virt->partial_start = start_line;
+        virt->partial_end = end_line;
+    }
+    virt->partial = enable;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_virtual_set_idle(esp_lcd_panel_handle_t panel, bool enable)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    virt->idle = enable;
+    return ESP_OK;
+}
+
+// Whether a display line is driven; PTLAR wraps around when start > end
+static bool panel_virtual_line_shown(const virtual_panel_t *virt, int line)
+{
+    if (!virt->partial) {
+        return true;
+    }
+    if (virt->partial_start <= virt->partial_end) {
+        return line >= virt->partial_start && line <= virt->partial_end;
+    }
+    return line >= virt->partial_start || line <= virt->partial_end;
+}
+
+// Frame memory row the panel scans out for a display line, after vertical scrolling
+static int panel_virtual_scan_row(const virtual_panel_t *virt, int line)
+{
+    int rel = line - virt->scroll_top;
+    if (rel < 0 || rel >= virt->scroll_lines) {
+        return line;
+    }
+    return virt->scroll_top + (rel + virt->scroll_start - virt->scroll_top + virt->scroll_lines) % virt->scroll_lines;
+}
+
+bool esp_lcd_panel_virtual_is_busy(esp_lcd_panel_handle_t panel)
+{
+    if (panel == NULL) {
+        return false;
+    }
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    return __atomic_load_n(&virt->done_pending, __ATOMIC_ACQUIRE) != 0;
+}
+
+const uint16_t *esp_lcd_panel_virtual_get_frame(esp_lcd_panel_handle_t panel)
+{
+    if (panel == NULL) {
+        return NULL;
+    }
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    return virt->frame;
+}
+
+esp_err_t esp_lcd_panel_virtual_dump_ppm(esp_lcd_panel_handle_t panel, const char *path)
+{
+    ESP_RETURN_ON_FALSE(panel && path, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    virtual_panel_t *virt = __containerof(panel, virtual_panel_t, base);
+    const esp_lcd_panel_virtual_config_t *cfg = &virt->config;
+
+    FILE *f = fopen(path, "wb");
+    ESP_RETURN_ON_FALSE(f, ESP_FAIL, TAG, "open %s failed", path);
+    fprintf(f, "P6\n%d %d\n255\n", cfg->view_width, cfg->view_height);
+
+    uint8_t line[3 * 320];
+    int chunk_px = sizeof(line) / 3;
+    bool ok = true;
+    for (int y = 0; y < cfg->view_height && ok; y++) {
+        const uint16_t *row = &virt->frame[panel_virtual_scan_row(virt, cfg->view_y + y) * cfg->ram_cols];
+        bool shown = panel_virtual_line_shown(virt, cfg->view_y + y);
+        for (int x0 = 0; x0 < cfg->view_width && ok; x0 += chunk_px) {
+            int n = cfg->view_width - x0 < chunk_px ? cfg->view_width - x0 : chunk_px;
+            for (int i = 0; i < n; i++) {
+                int x = x0 + i;
+                int col = cfg->flags.view_mirror_x ? cfg->view_x + cfg->view_width - 1 - x : cfg->view_x + x;
+                uint16_t p = shown ? row[col] : 0;
+                if (virt->idle) {
+                    p &= 0x8410;    // MSB of each channel
+                    p |= (p & 0x8000 ? 0xF800 : 0) | (p & 0x0400 ? 0x07E0 : 0) | (p & 0x0010 ? 0x001F : 0);
+                }
+                uint8_t r = (p >> 11) & 0x1F;
+                uint8_t g = (p >> 5) & 0x3F;
+                uint8_t b = p & 0x1F;
+                line[3 * i + 0] = (r << 3) | (r >> 2);
+                line[3 * i + 1] = (g << 2) | (g >> 4);
+                line[3 * i + 2] = (b << 3) | (b >> 2);
+            }
+            ok = fwrite(line, 3, n, f) == (size_t)n;
+        }
+    }
+    ok = (fclose(f) == 0) && ok;
+    ESP_RETURN_ON_FALSE(ok, ESP_FAIL, TAG, "write %s failed", path);
+    return ESP_OK;
+}
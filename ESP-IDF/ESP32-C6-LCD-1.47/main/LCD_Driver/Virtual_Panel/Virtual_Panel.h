@@ -0,0 +1,212 @@
+/*
+ * Virtual LCD panel: an esp_lcd panel backed by an in-memory frame buffer
+ *
+ * Behaves like the ST7789T panel driver towards its users (draw_bitmap,
+ * mirror, swap_xy, gap, completion callback) but keeps the pixels in RAM
+ * and models the SPI bus instead of driving one. The driver only uses the
+ * esp_lcd panel interface and plain C, so it also runs without the LCD
+ * wired up, and frames can be dumped as PPM images.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Color transfer done callback
+ *
+ * Called once the modeled transfer of a draw_bitmap call has finished, i.e.
+ * the color buffer may be reused. Runs from the esp_timer ISR (or task) in
+ * realtime mode, otherwise from inside draw_bitmap.
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] user_ctx User context passed in the configuration
+ * @return Whether a high priority task has been woken up by this function
+ */
+typedef bool (*esp_lcd_panel_virtual_done_cb_t)(esp_lcd_panel_handle_t panel, void *user_ctx);
+
+/**
+ * @brief Configuration structure for the virtual panel
+ */
+typedef struct {
+    int ram_cols;                       /*!< Frame memory columns (ST7789: 240) */
+    int ram_rows;                       /*!< Frame memory rows (ST7789: 320) */
+    int view_x;                         /*!< First frame memory column visible on the glass */
+    int view_y;                         /*!< First frame memory row visible on the glass */
+    int view_width;                     /*!< Visible width in pixels */
+    int view_height;                    /*!< Visible height in pixels */
+    int pclk_hz;                        /*!< Modeled SPI clock */
+    int trans_overhead_us;              /*!< Modeled setup cost of every SPI transaction */
+    esp_lcd_panel_virtual_done_cb_t on_color_trans_done; /*!< Transfer done callback, optional */
+    void *user_ctx;                     /*!< Context for on_color_trans_done */
+    struct {
+        unsigned int view_mirror_x: 1;  /*!< The glass shows frame memory columns right to left */
+        unsigned int pixel_le: 1;       /*!< Pixels arrive low byte first (RAMCTRL ENDIAN set) */
+        unsigned int realtime: 1;       /*!< Report transfer done after the modeled bus time, wait out reset and init delays */
+    } flags;
+} esp_lcd_panel_virtual_config_t;
+
+/**
+ * @brief Modeled bus statistics
+ */
+typedef struct {
+    uint32_t draws;         /*!< draw_bitmap calls */
+    uint32_t transactions;  /*!< Modeled SPI transactions (CASET, RASET, RAMWR + pixels) */
+    uint64_t cmd_bytes;     /*!< Command and parameter bytes */
+    uint64_t pixel_bytes;   /*!< Pixel bytes */
+    uint64_t bus_time_us;   /*!< Modeled time the bus was busy */
+} esp_lcd_panel_virtual_stats_t;
+
+/**
+ * @brief Create a virtual LCD panel
+ *
+ * @param[in] config Panel configuration
+ * @param[out] ret_panel Returned LCD panel handle
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NO_MEM        if out of memory
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_new_panel_virtual(const esp_lcd_panel_virtual_config_t *config, esp_lcd_panel_handle_t *ret_panel);
+
+/**
+ * @brief Get modeled bus statistics
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[out] stats Returned statistics
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_get_stats(esp_lcd_panel_handle_t panel, esp_lcd_panel_virtual_stats_t *stats);
+
+/**
+ * @brief Reset modeled bus statistics
+ *
+ * @param[in] panel Virtual panel handle
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_reset_stats(esp_lcd_panel_handle_t panel);
+
+/**
+ * @brief Change the modeled SPI clock
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] pclk_hz New clock in Hz
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_set_pclk(esp_lcd_panel_handle_t panel, int pclk_hz);
+
+/**
+ * @brief Change the color depth of incoming pixels (ST7789 COLMOD)
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] bits_per_pixel 16 (RGB565) or 12 (RGB444, two pixels in three bytes)
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NOT_SUPPORTED if the color depth is not supported
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_set_bits_per_pixel(esp_lcd_panel_handle_t panel, unsigned int bits_per_pixel);
+
+/**
+ * @brief Define the vertical scroll area (ST7789 VSCRDEF)
+ *
+ * Only affects esp_lcd_panel_virtual_dump_ppm(), which shows the image the
+ * way the panel scans it out. get_frame() stays the raw frame memory.
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] top_fixed Rows fixed at the top
+ * @param[in] scroll_lines Rows in the scroll area
+ * @param[in] bottom_fixed Rows fixed at the bottom, the three must add up to ram_rows
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_set_scroll_area(esp_lcd_panel_handle_t panel, int top_fixed, int scroll_lines, int bottom_fixed);
+
+/**
+ * @brief Set the vertical scroll start address (ST7789 VSCSAD)
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] line Frame memory row shown at the top of the scroll area
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_set_scroll_start(esp_lcd_panel_handle_t panel, int line);
+
+/**
+ * @brief Enter partial mode (ST7789 PTLAR + PTLON) or go back to normal mode
+ *
+ * Like scrolling, this only affects esp_lcd_panel_virtual_dump_ppm(): lines
+ * outside the partial area come out black.
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] enable true for partial mode, false for normal mode
+ * @param[in] start_line First displayed frame memory row
+ * @param[in] end_line Last displayed frame memory row
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_set_partial(esp_lcd_panel_handle_t panel, bool enable, int start_line, int end_line);
+
+/**
+ * @brief Switch 8-color idle mode (ST7789 IDMON/IDMOFF)
+ *
+ * esp_lcd_panel_virtual_dump_ppm() keeps only the MSB of each channel.
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] enable true for idle mode
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_set_idle(esp_lcd_panel_handle_t panel, bool enable);
+
+/**
+ * @brief Check if a modeled transfer has not reported done yet
+ *
+ * Only realtime mode has transfers in flight.
+ *
+ * @param[in] panel Virtual panel handle
+ * @return true while the done callback of a draw_bitmap call is pending
+ */
+bool esp_lcd_panel_virtual_is_busy(esp_lcd_panel_handle_t panel);
+
+/**
+ * @brief Get the frame memory
+ *
+ * Pixels are RGB565 in CPU byte order, ram_cols x ram_rows, row major.
+ *
+ * @param[in] panel Virtual panel handle
+ * @return Frame memory, NULL if panel is invalid
+ */
+const uint16_t *esp_lcd_panel_virtual_get_frame(esp_lcd_panel_handle_t panel);
+
+/**
+ * @brief Write the visible part of the frame memory as a binary PPM (P6) image
+ *
+ * @param[in] panel Virtual panel handle
+ * @param[in] path File to create
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_FAIL              if the file could not be written
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_panel_virtual_dump_ppm(esp_lcd_panel_handle_t panel, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,9 +7,22 @@
 
 #include "LVGL_Driver.h"
 #include "ST7789.h"  // Include full ST7789 definitions
+#include "Pixel_Ops.h"
 
 static const char *TAG = "LVGL_Driver";
 
+static bool lvgl_trans_done_callback(void *user_ctx);
+static void lvgl_render_task(void *arg);
+static void lvgl_render_start_callback(lv_disp_drv_t *drv);
+static esp_err_t lvgl_alloc_buffers(lvgl_driver_t *driver, uint16_t buf_lines, bool double_buffer);
+static void lvgl_free_buffers(lvgl_driver_t *driver);
+static void lvgl_calibrate_buffers(lvgl_driver_t *driver);
+static void lvgl_panel_idle_check(lvgl_driver_t *driver);
+static void lvgl_panel_set_idle(lvgl_driver_t *driver, bool idle);
+#if CONFIG_LVGL_DRIVER_METRICS
+static void lvgl_monitor_callback(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px);
+#endif
+
 /******************************************************************************
  * Default Configuration
  ******************************************************************************/
@@ -30,8 +43,19 @@ lvgl_config_t lvgl_get_default_config(st7789_device_t *lcd_device)
         .buf_alloc = LVGL_BUF_ALLOC_INTERNAL,
         .full_refresh = false,
         .rotation = 0,
+        .merge_flush_cost_us = LVGL_MERGE_FLUSH_COST_US,
         .lcd_device = lcd_device,
         .tick_period_ms = LVGL_TICK_PERIOD_MS,
+        .use_render_task = true,
+        .task_stack_size = LVGL_TASK_STACK_SIZE,
+        .task_priority = LVGL_TASK_PRIORITY,
+        .task_core = LVGL_TASK_CORE,
+        .task_max_sleep_ms = LVGL_TASK_MAX_SLEEP_MS,
+        .idle_timeout_ms = LVGL_PANEL_IDLE_TIMEOUT_MS,
+        .idle_frame_rate = LVGL_PANEL_IDLE_FRAME_RATE,
+        .idle_8_color = false,
+        .idle_partial_top = 0,
+        .idle_partial_height = 0,
     };
 
     return config;
@@ -60,6 +84,7 @@ lvgl_driver_t* lvgl_driver_create(const lvgl_config_t *config)
 
     // Calculate buffer size
     driver->buf_size = driver->config.hor_res * driver->config.buf_lines;
+    driver->color_depth = 16;
 
     ESP_LOGI(TAG, "LVGL driver created: %dx%d, buf_lines=%d, double_buf=%d",
              driver->config.hor_res, driver->config.ver_res,
@@ -86,58 +111,50 @@ esp_err_t lvgl_driver_init(lvgl_driver_t *driver)
     lv_init();
     ESP_LOGI(TAG, "✓ LVGL library initialized");
 
-    // Step 2: Allocate display buffers
-    uint32_t malloc_caps = MALLOC_CAP_8BIT;
-    switch (driver->config.buf_alloc) {
-        case LVGL_BUF_ALLOC_SPIRAM:
-            malloc_caps = MALLOC_CAP_SPIRAM;
-            ESP_LOGI(TAG, "Using SPIRAM for display buffers");
-            break;
-        case LVGL_BUF_ALLOC_DMA:
-            malloc_caps = MALLOC_CAP_DMA;
-            ESP_LOGI(TAG, "Using DMA-capable memory for buffers");
-            break;
-        case LVGL_BUF_ALLOC_INTERNAL:
-        default:
-            malloc_caps = MALLOC_CAP_INTERNAL;
-            ESP_LOGI(TAG, "Using internal RAM for buffers");
-            break;
-    }
-
-    size_t buf_bytes = driver->buf_size * sizeof(lv_color_t);
-    driver->buf1 = (lv_color_t *)heap_caps_malloc(buf_bytes, malloc_caps);
-    if (driver->buf1 == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate buffer1 (%d bytes)", buf_bytes);
+    // Step 2: Hook flush completion to the color transfer done interrupt
+    driver->flush_done_sem = xSemaphoreCreateBinary();
+    if (driver->flush_done_sem == NULL) {
+        ESP_LOGE(TAG, "Failed to create flush semaphore");
         return ESP_ERR_NO_MEM;
     }
-    ESP_LOGI(TAG, "✓ Buffer1 allocated: %d bytes", buf_bytes);
+    esp_err_t ret = st7789_register_trans_done_cb(driver->config.lcd_device, lvgl_trans_done_callback, driver);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register transfer done callback: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "✓ Asynchronous flush enabled");
 
-    if (driver->config.use_double_buffer) {
-        driver->buf2 = (lv_color_t *)heap_caps_malloc(buf_bytes, malloc_caps);
-        if (driver->buf2 == NULL) {
-            ESP_LOGE(TAG, "Failed to allocate buffer2");
-            free(driver->buf1);
-            return ESP_ERR_NO_MEM;
-        }
-        ESP_LOGI(TAG, "✓ Buffer2 allocated: %d bytes (double buffering)", buf_bytes);
-    } else {
-        driver->buf2 = NULL;
-        ESP_LOGI(TAG, "✓ Single buffer mode");
+    // Step 3: Allocate display buffers, optionally sized by calibration
+    if (driver->config.calibrate_buffers) {
+        lvgl_calibrate_buffers(driver);
+    }
+    ret = lvgl_alloc_buffers(driver, driver->config.buf_lines, driver->config.use_double_buffer);
+    if (ret != ESP_OK) {
+        return ret;
     }
+    ESP_LOGI(TAG, "✓ Buffers allocated: %d lines, %d bytes each (%s)",
+             driver->config.buf_lines, (int)(driver->buf_size * sizeof(lv_color_t)),
+             driver->buf2 != NULL ? "double buffering" : "single buffer");
 
-    // Step 3: Initialize LVGL draw buffer
+    // Step 4: Initialize LVGL draw buffer
     lv_disp_draw_buf_init(&driver->draw_buf, driver->buf1, driver->buf2, driver->buf_size);
     ESP_LOGI(TAG, "✓ LVGL draw buffer initialized");
 
-    // Step 4: Initialize and register display driver
+    // Step 5: Initialize and register display driver
     lv_disp_drv_init(&driver->disp_drv);
     driver->disp_drv.hor_res = driver->config.hor_res;
     driver->disp_drv.ver_res = driver->config.ver_res;
     driver->disp_drv.flush_cb = lvgl_flush_callback;
+    driver->disp_drv.wait_cb = lvgl_flush_wait_callback;
     driver->disp_drv.drv_update_cb = lvgl_rotation_callback;
     driver->disp_drv.draw_buf = &driver->draw_buf;
     driver->disp_drv.user_data = driver;  // Store driver object for callbacks
     driver->disp_drv.full_refresh = driver->config.full_refresh;
+    driver->disp_drv.render_start_cb = lvgl_render_start_callback;
+#if CONFIG_LVGL_DRIVER_METRICS
+    driver->disp_drv.monitor_cb = lvgl_monitor_callback;
+    lvgl_driver_reset_metrics(driver);
+#endif
 
     driver->display = lv_disp_drv_register(&driver->disp_drv);
     if (driver->display == NULL) {
@@ -146,12 +163,17 @@ esp_err_t lvgl_driver_init(lvgl_driver_t *driver)
     }
     ESP_LOGI(TAG, "✓ Display driver registered");
 
-    // Step 5: Apply initial rotation
+    // Step 6: Apply initial rotation
     if (driver->config.rotation != 0) {
         lvgl_driver_set_rotation(driver, driver->config.rotation);
     }
 
-    // Step 6: Create and start tick timer
+    // Step 7: Tick source
+#if CONFIG_LV_TICK_CUSTOM
+    // lv_tick_get() reads esp_timer_get_time() directly (see sdkconfig.defaults
+    // and the project CMakeLists.txt), no periodic interrupt is needed
+    ESP_LOGI(TAG, "✓ Tick derived from esp_timer_get_time()");
+#else
     const esp_timer_create_args_t timer_args = {
         .callback = lvgl_tick_callback,
         .arg = driver,
@@ -159,7 +181,7 @@ esp_err_t lvgl_driver_init(lvgl_driver_t *driver)
         .dispatch_method = ESP_TIMER_TASK,
     };
 
-    esp_err_t ret = esp_timer_create(&timer_args, &driver->tick_timer);
+    ret = esp_timer_create(&timer_args, &driver->tick_timer);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create tick timer: %s", esp_err_to_name(ret));
         return ret;
@@ -172,8 +194,30 @@ esp_err_t lvgl_driver_init(lvgl_driver_t *driver)
         return ret;
     }
     ESP_LOGI(TAG, "✓ Tick timer started (%d ms period)", driver->config.tick_period_ms);
+#endif
 
+    // Step 8: Start render task
+    driver->lock = xSemaphoreCreateRecursiveMutex();
+    if (driver->lock == NULL) {
+        ESP_LOGE(TAG, "Failed to create LVGL lock");
+        return ESP_ERR_NO_MEM;
+    }
+    driver->last_frame_us = esp_timer_get_time();
     driver->is_initialized = true;
+
+    if (driver->config.use_render_task) {
+        driver->task_running = true;
+        if (xTaskCreatePinnedToCore(lvgl_render_task, "lvgl", driver->config.task_stack_size, driver,
+                                    driver->config.task_priority, &driver->render_task,
+                                    driver->config.task_core) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create render task");
+            driver->task_running = false;
+            driver->is_initialized = false;
+            return ESP_ERR_NO_MEM;
+        }
+        ESP_LOGI(TAG, "✓ Render task started (priority %d)", driver->config.task_priority);
+    }
+
     ESP_LOGI(TAG, "========================================");
     ESP_LOGI(TAG, "LVGL driver initialization complete!");
     ESP_LOGI(TAG, "Resolution: %dx%d", driver->config.hor_res, driver->config.ver_res);
@@ -193,6 +237,19 @@ esp_err_t lvgl_driver_destroy(lvgl_driver_t *driver)
 
     ESP_LOGI(TAG, "Destroying LVGL driver...");
 
+    // Stop render task; it clears render_task on its way out
+    if (driver->render_task != NULL) {
+        driver->task_running = false;
+        xTaskNotifyGive(driver->render_task);
+        while (driver->render_task != NULL) {
+            vTaskDelay(1);
+        }
+    }
+    if (driver->lock != NULL) {
+        vSemaphoreDelete(driver->lock);
+        driver->lock = NULL;
+    }
+
     // Stop and delete tick timer
     if (driver->tick_timer != NULL) {
         esp_timer_stop(driver->tick_timer);
@@ -200,7 +257,72 @@ esp_err_t lvgl_driver_destroy(lvgl_driver_t *driver)
         driver->tick_timer = NULL;
     }
 
+    // Leave the panel in full mode for whoever draws next
+    if (driver->panel_idle) {
+        lvgl_panel_set_idle(driver, false);
+    }
+
+    // Stop flush notifications before the buffers go away
+    st7789_register_trans_done_cb(driver->config.lcd_device, NULL, NULL);
+    if (driver->flush_done_sem != NULL) {
+        vSemaphoreDelete(driver->flush_done_sem);
+        driver->flush_done_sem = NULL;
+    }
+
     // Free buffers
+    lvgl_free_buffers(driver);
+    free(driver->conv_buf);
+    driver->conv_buf = NULL;
+
+    // Free driver object
+    free(driver);
+
+    ESP_LOGI(TAG, "LVGL driver destroyed");
+    return ESP_OK;
+}
+
+/******************************************************************************
+ * Draw Buffers
+ ******************************************************************************/
+
+static uint32_t lvgl_buffer_caps(lvgl_buffer_alloc_t alloc)
+{
+    switch (alloc) {
+        case LVGL_BUF_ALLOC_SPIRAM:
+            return MALLOC_CAP_SPIRAM;
+        case LVGL_BUF_ALLOC_DMA:
+            return MALLOC_CAP_DMA;
+        case LVGL_BUF_ALLOC_INTERNAL:
+        default:
+            return MALLOC_CAP_INTERNAL;
+    }
+}
+
+static esp_err_t lvgl_alloc_buffers(lvgl_driver_t *driver, uint16_t buf_lines, bool double_buffer)
+{
+    uint32_t malloc_caps = lvgl_buffer_caps(driver->config.buf_alloc);
+    size_t buf_size = driver->config.hor_res * buf_lines;
+    size_t buf_bytes = buf_size * sizeof(lv_color_t);
+
+    driver->buf1 = (lv_color_t *)heap_caps_malloc(buf_bytes, malloc_caps);
+    if (driver->buf1 == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate buffer1 (%d bytes)", (int)buf_bytes);
+        return ESP_ERR_NO_MEM;
+    }
+    if (double_buffer) {
+        driver->buf2 = (lv_color_t *)heap_caps_malloc(buf_bytes, malloc_caps);
+        if (driver->buf2 == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate buffer2 (%d bytes)", (int)buf_bytes);
+            lvgl_free_buffers(driver);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    driver->buf_size = buf_size;
+    return ESP_OK;
+}
+
+static void lvgl_free_buffers(lvgl_driver_t *driver)
+{
     if (driver->buf1 != NULL) {
         free(driver->buf1);
         driver->buf1 = NULL;
@@ -209,12 +331,161 @@ esp_err_t lvgl_driver_destroy(lvgl_driver_t *driver)
         free(driver->buf2);
         driver->buf2 = NULL;
     }
+}
 
-    // Free driver object
-    free(driver);
+/**
+ * @brief Synthetic workload: a gradient background, a row of labels and
+ *        an arc, close to the demo screens in cost
+ */
+static void calib_create_scene(lv_obj_t *scr, lv_obj_t **labels, int label_cnt)
+{
+    lv_obj_set_style_bg_color(scr, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_style_bg_grad_color(scr, lv_palette_darken(LV_PALETTE_BLUE, 4), 0);
+    lv_obj_set_style_bg_grad_dir(scr, LV_GRAD_DIR_VER, 0);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
 
-    ESP_LOGI(TAG, "LVGL driver destroyed");
-    return ESP_OK;
+    lv_obj_t *arc = lv_arc_create(scr);
+    lv_obj_set_size(arc, 120, 120);
+    lv_arc_set_value(arc, 70);
+    lv_obj_align(arc, LV_ALIGN_BOTTOM_MID, 0, -10);
+
+    for (int i = 0; i < label_cnt; i++) {
+        labels[i] = lv_label_create(scr);
+        lv_obj_align(labels[i], LV_ALIGN_TOP_LEFT, 10, 10 + i * 30);
+    }
+}
+
+/**
+ * @brief Average time of one calibration pass at the current buffers
+ *
+ * Even frames redraw the whole screen, odd frames only change the labels,
+ * so both full-screen and small-area refreshes are in the average. A frame
+ * ends when its last flush has left the DMA.
+ */
+static uint32_t calib_measure(lvgl_driver_t *driver)
+{
+    lv_disp_t *disp = lv_disp_drv_register(&driver->disp_drv);
+    if (disp == NULL) {
+        return UINT32_MAX;
+    }
+
+    lv_obj_t *scr = lv_disp_get_scr_act(disp);
+    lv_obj_t *labels[LVGL_CALIB_LABELS];
+    calib_create_scene(scr, labels, LVGL_CALIB_LABELS);
+
+    int64_t total_us = 0;
+    for (int frame = -1; frame < LVGL_CALIB_FRAMES; frame++) {
+        if (frame % 2 == 0) {
+            lv_obj_invalidate(scr);
+        } else {
+            for (int i = 0; i < LVGL_CALIB_LABELS; i++) {
+                lv_label_set_text_fmt(labels[i], "Calibration %d.%d", frame, i);
+            }
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        lv_refr_now(disp);
+        while (driver->draw_buf.flushing) {
+            lvgl_flush_wait_callback(&driver->disp_drv);
+        }
+        if (frame >= 0) {       // Frame -1 warms up caches and creates the styles
+            total_us += esp_timer_get_time() - start_us;
+        }
+    }
+
+    lv_disp_remove(disp);
+    return (uint32_t)(total_us / LVGL_CALIB_FRAMES);
+}
+
+/**
+ * @brief Pick buf_lines and double buffering by measurement
+ *
+ * Every candidate within the RAM budget renders the synthetic workload on
+ * a temporary display. The cheapest candidate whose frame time is within
+ * LVGL_CALIB_TOLERANCE_PCT of the fastest one is written to the config,
+ * so RAM is only spent where it buys frame time.
+ */
+static void lvgl_calibrate_buffers(lvgl_driver_t *driver)
+{
+    static const uint16_t lines[] = { 10, 20, 40, 80, 160 };
+    struct {
+        uint16_t lines;
+        bool double_buffer;
+        size_t bytes;
+        uint32_t frame_us;
+    } result[2 * sizeof(lines) / sizeof(lines[0])];
+    int result_cnt = 0;
+
+    size_t budget = driver->config.calib_ram_budget;
+    if (budget == 0) {
+        budget = heap_caps_get_free_size(lvgl_buffer_caps(driver->config.buf_alloc)) / 4;
+    }
+    ESP_LOGI(TAG, "Calibrating draw buffers (RAM budget %d bytes)...", (int)budget);
+
+    lv_disp_drv_init(&driver->disp_drv);
+    driver->disp_drv.hor_res = driver->config.hor_res;
+    driver->disp_drv.ver_res = driver->config.ver_res;
+    driver->disp_drv.flush_cb = lvgl_flush_callback;
+    driver->disp_drv.wait_cb = lvgl_flush_wait_callback;
+    driver->disp_drv.draw_buf = &driver->draw_buf;
+    driver->disp_drv.user_data = driver;
+
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+        uint16_t buf_lines = lines[i] < driver->config.ver_res ? lines[i] : driver->config.ver_res;
+        for (int double_buffer = 0; double_buffer <= 1; double_buffer++) {
+            size_t bytes = (size_t)driver->config.hor_res * buf_lines * sizeof(lv_color_t) * (double_buffer + 1);
+            if (bytes > budget || lvgl_alloc_buffers(driver, buf_lines, double_buffer) != ESP_OK) {
+                continue;
+            }
+            lv_disp_draw_buf_init(&driver->draw_buf, driver->buf1, driver->buf2, driver->buf_size);
+            uint32_t frame_us = calib_measure(driver);
+            lvgl_free_buffers(driver);
+
+            result[result_cnt].lines = buf_lines;
+            result[result_cnt].double_buffer = double_buffer;
+            result[result_cnt].bytes = bytes;
+            result[result_cnt].frame_us = frame_us;
+            result_cnt++;
+            ESP_LOGI(TAG, "  %3d lines %s: %6d bytes, %6lu us/frame", buf_lines,
+                     double_buffer ? "double" : "single", (int)bytes, (unsigned long)frame_us);
+        }
+        if (buf_lines == driver->config.ver_res) {
+            break;
+        }
+    }
+
+    // The first temporary display allocated a draw context in disp_drv.
+    // lv_disp_remove() leaves it there and the real driver init clears it
+    if (driver->disp_drv.draw_ctx != NULL) {
+        driver->disp_drv.draw_ctx_deinit(&driver->disp_drv, driver->disp_drv.draw_ctx);
+        lv_mem_free(driver->disp_drv.draw_ctx);
+        driver->disp_drv.draw_ctx = NULL;
+    }
+
+    if (result_cnt == 0) {
+        ESP_LOGW(TAG, "No buffer setting fits the budget, keeping %d lines", driver->config.buf_lines);
+        return;
+    }
+
+    uint32_t best_us = UINT32_MAX;
+    for (int i = 0; i < result_cnt; i++) {
+        if (result[i].frame_us < best_us) {
+            best_us = result[i].frame_us;
+        }
+    }
+    int pick = -1;
+    for (int i = 0; i < result_cnt; i++) {
+        if ((uint64_t)result[i].frame_us * 100 <= (uint64_t)best_us * (100 + LVGL_CALIB_TOLERANCE_PCT) &&
+            (pick < 0 || result[i].bytes < result[pick].bytes)) {
+            pick = i;
+        }
+    }
+
+    driver->config.buf_lines = result[pick].lines;
+    driver->config.use_double_buffer = result[pick].double_buffer;
+    ESP_LOGI(TAG, "✓ Calibration picked %d lines, %s buffer (%lu us/frame, %d bytes)",
+             result[pick].lines, result[pick].double_buffer ? "double" : "single",
+             (unsigned long)result[pick].frame_us, (int)result[pick].bytes);
 }
 
 /******************************************************************************
@@ -245,6 +516,10 @@ esp_err_t lvgl_driver_set_rotation(lvgl_driver_t *driver, uint16_t rotation)
             ESP_LOGE(TAG, "Invalid rotation: %d (must be 0/90/180/270)", rotation);
             return ESP_ERR_INVALID_ARG;
     }
+    if (rotation != 0 && driver->scroll_height != 0) {
+        ESP_LOGE(TAG, "Switch hardware scrolling off before rotating");
+        return ESP_ERR_INVALID_STATE;
+    }
 
     lv_disp_set_rotation(driver->display, lv_rotation);
     driver->config.rotation = rotation;
@@ -253,6 +528,184 @@ esp_err_t lvgl_driver_set_rotation(lvgl_driver_t *driver, uint16_t rotation)
     return ESP_OK;
 }
 
+esp_err_t lvgl_driver_set_color_depth(lvgl_driver_t *driver, uint8_t bits_per_pixel)
+{
+    if (driver == NULL || !driver->is_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (bits_per_pixel != 12 && bits_per_pixel != 16) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!lvgl_driver_lock(driver, -1)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = ESP_OK;
+    if (bits_per_pixel == 12 && driver->conv_buf == NULL) {
+        // A flush split at the scroll region packs up to 4 parts, each may end on a half pixel
+        driver->conv_buf = heap_caps_malloc(pixel_444_bytes(driver->buf_size) + 4, MALLOC_CAP_DMA);
+        if (driver->conv_buf == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate RGB444 buffer");
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+    if (ret == ESP_OK) {
+        // The staging buffer may still be on the wire
+        while (driver->draw_buf.flushing) {
+            lvgl_flush_wait_callback(&driver->disp_drv);
+        }
+        ret = st7789_set_color_depth(driver->config.lcd_device, bits_per_pixel);
+    }
+    if (ret == ESP_OK) {
+        driver->color_depth = bits_per_pixel;
+    }
+
+    xSemaphoreGiveRecursive(driver->lock);  // Nothing to redraw
+    return ret;
+}
+
+/**
+ * @brief Program VSCRDEF/VSCSAD for the current scroll region and offset
+ */
+static esp_err_t lvgl_apply_scroll(lvgl_driver_t *driver)
+{
+    st7789_device_t *lcd = driver->config.lcd_device;
+    uint16_t tfa = lcd->config.offset_y + driver->scroll_top;
+    uint16_t vsa = driver->scroll_height;
+
+    if (vsa == 0) {
+        // Whole frame memory as scroll area at start 0: no scrolling
+        tfa = 0;
+        vsa = ST7789_RAM_ROWS;
+    }
+    esp_err_t ret = st7789_set_scroll_area(lcd, tfa, vsa, ST7789_RAM_ROWS - tfa - vsa);
+    if (ret == ESP_OK) {
+        ret = st7789_set_scroll_start(lcd, driver->scroll_height ? tfa + driver->scroll_offset : 0);
+    }
+    return ret;
+}
+
+esp_err_t lvgl_driver_set_scroll_area(lvgl_driver_t *driver, uint16_t top, uint16_t height)
+{
+    if (driver == NULL || !driver->is_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (top + height > driver->config.ver_res) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (height != 0 && (driver->config.rotation != 0 || driver->disp_drv.full_refresh)) {
+        ESP_LOGE(TAG, "Hardware scrolling needs rotation 0 and partial refresh");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (!lvgl_driver_lock(driver, -1)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // The frame memory layout is rotated while the offset is not 0
+    bool redraw = driver->scroll_offset != 0;
+    driver->scroll_top = top;
+    driver->scroll_height = height;
+    driver->scroll_offset = 0;
+
+    esp_err_t ret = lvgl_apply_scroll(driver);
+    if (redraw) {
+        lv_obj_invalidate(lv_disp_get_scr_act(driver->display));
+    }
+    xSemaphoreGiveRecursive(driver->lock);
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Scroll area: rows %d-%d", top, top + height - 1);
+    }
+    return ret;
+}
+
+esp_err_t lvgl_driver_scroll(lvgl_driver_t *driver, lv_obj_t *obj, lv_coord_t dy)
+{
+    if (driver == NULL || !driver->is_initialized || obj == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (driver->scroll_height == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (dy == 0) {
+        return ESP_OK;
+    }
+
+    lv_disp_t *disp = driver->display;
+    int top = driver->scroll_top;
+    int h = driver->scroll_height;
+
+    // Drop the redraw of the band that LVGL queues for the scroll, but keep
+    // whatever else scroll_by invalidated outside the band (scroll handlers,
+    // restyled objects, the object's own shadow or outline): areas inside
+    // the band are dropped, areas crossing its edges are cut back to the
+    // rows outside it. If the list overflowed and LVGL replaced the areas
+    // queued before the scroll with the whole screen, it is left alone.
+    uint16_t pending = disp->inv_p;
+    lv_obj_scroll_by(obj, 0, -dy, LV_ANIM_OFF);
+    if (disp->inv_p > pending) {
+        lv_area_t below[LV_INV_BUF_SIZE];
+        uint16_t below_cnt = 0;
+        uint16_t kept = pending;
+        for (uint16_t i = pending; i < disp->inv_p; i++) {
+            lv_area_t area = disp->inv_areas[i];
+            if (area.y2 >= top && area.y1 < top + h) {
+                if (area.y2 >= top + h) {
+                    below[below_cnt] = area;
+                    below[below_cnt].y1 = top + h;
+                    below_cnt++;
+                }
+                if (area.y1 >= top) {
+                    continue;
+                }
+                area.y2 = top - 1;
+            }
+            disp->inv_areas[kept] = area;
+            disp->inv_area_joined[kept] = disp->inv_area_joined[i];
+            kept++;
+        }
+        disp->inv_p = kept;
+        for (uint16_t i = 0; i < below_cnt; i++) {
+            _lv_inv_area(disp, &below[i]);
+        }
+    }
+
+    driver->scroll_offset = ((driver->scroll_offset + dy) % h + h) % h;
+    esp_err_t ret = lvgl_apply_scroll(driver);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Areas invalidated before the scroll now show their content dy rows
+    // further up; their frame memory rows have not been redrawn yet
+    for (uint16_t i = 0; i < pending && i < disp->inv_p; i++) {
+        lv_area_t moved = disp->inv_areas[i];
+        if (moved.y2 < top || moved.y1 >= top + h) {
+            continue;
+        }
+        moved.y1 = LV_MAX(moved.y1 - dy, top);
+        moved.y2 = LV_MIN(moved.y2 - dy, top + h - 1);
+        if (moved.y1 <= moved.y2) {
+            _lv_inv_area(disp, &moved);
+        }
+    }
+
+    // Rows that came into view
+    lv_area_t exposed = {
+        .x1 = 0,
+        .x2 = lv_disp_get_hor_res(disp) - 1,
+        .y1 = top,
+        .y2 = top + h - 1,
+    };
+    if (dy > 0 && dy < h) {
+        exposed.y1 = top + h - dy;
+    } else if (dy < 0 && -dy < h) {
+        exposed.y2 = top - dy - 1;
+    }
+    _lv_inv_area(disp, &exposed);
+    return ESP_OK;
+}
+
 lv_disp_t* lvgl_driver_get_display(lvgl_driver_t *driver)
 {
     if (driver == NULL) {
@@ -263,22 +716,452 @@ lv_disp_t* lvgl_driver_get_display(lvgl_driver_t *driver)
 
 void lvgl_driver_task_handler(lvgl_driver_t *driver)
 {
-    // Driver parameter is currently unused, but reserved for future use
-    // LVGL task handler works globally
-    lv_timer_handler();
+    if (driver == NULL) {
+        // Legacy API: LVGL task handler works globally
+        lv_timer_handler();
+        return;
+    }
+
+    if (driver->render_task != NULL) {
+        lvgl_driver_wake(driver);
+        return;
+    }
+
+    if (lvgl_driver_lock(driver, -1)) {
+        lv_timer_handler();
+        lvgl_panel_idle_check(driver);
+        lvgl_driver_unlock(driver);
+    }
+}
+
+bool lvgl_driver_lock(lvgl_driver_t *driver, int timeout_ms)
+{
+    if (driver == NULL || driver->lock == NULL) {
+        return false;
+    }
+
+    TickType_t ticks = (timeout_ms < 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTakeRecursive(driver->lock, ticks) == pdTRUE;
+}
+
+void lvgl_driver_unlock(lvgl_driver_t *driver)
+{
+    if (driver == NULL || driver->lock == NULL) {
+        return;
+    }
+
+    xSemaphoreGiveRecursive(driver->lock);
+    if (xTaskGetCurrentTaskHandle() != driver->render_task) {
+        lvgl_driver_wake(driver);
+    }
+}
+
+void lvgl_driver_wake(lvgl_driver_t *driver)
+{
+    if (driver != NULL && driver->render_task != NULL) {
+        xTaskNotifyGive(driver->render_task);
+    }
+}
+
+/**
+ * @brief Render task: run LVGL, then sleep until its next deadline
+ *
+ * lv_timer_handler() returns the time until the next LVGL timer is due.
+ * The task blocks on its notification for that long, so it wakes
+ * exactly when there is work or when another task calls wake/unlock.
+ */
+static void lvgl_render_task(void *arg)
+{
+    lvgl_driver_t *driver = (lvgl_driver_t *)arg;
+
+    while (driver->task_running) {
+        driver->task_wakeups++;
+        uint32_t sleep_ms = driver->config.task_max_sleep_ms;
+        if (lvgl_driver_lock(driver, -1)) {
+            sleep_ms = lv_timer_handler();
+            lvgl_panel_idle_check(driver);
+            lvgl_driver_unlock(driver);
+        }
+
+        if (sleep_ms > driver->config.task_max_sleep_ms) {
+            sleep_ms = driver->config.task_max_sleep_ms;   // also covers LV_NO_TIMER_READY
+        }
+        // Round up: waking before the deadline only costs an empty pass
+        TickType_t ticks = (sleep_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+        ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1);
+    }
+
+    driver->render_task = NULL;
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+ * Area Merging
+ ******************************************************************************/
+
+/**
+ * @brief Cost of refreshing an area, in pixel transfer times
+ *
+ * LVGL renders an area in chunks of at most buf_size / width rows and
+ * flushes every chunk, so each chunk pays the fixed flush cost once.
+ */
+static uint32_t area_refresh_cost(const lv_area_t *area, uint32_t buf_size, uint32_t flush_cost_px)
+{
+    uint32_t w = lv_area_get_width(area);
+    uint32_t h = lv_area_get_height(area);
+    uint32_t max_rows = buf_size / w;
+    if (max_rows == 0) {
+        max_rows = 1;
+    }
+    return w * h + (h + max_rows - 1) / max_rows * flush_cost_px;
+}
+
+/**
+ * @brief Merge invalidated areas where one bounding box is cheaper
+ *
+ * LVGL only joins areas that overlap or touch, and only if the join adds no
+ * pixels. Small widgets updated in the same tick (e.g. stacked textareas)
+ * each cost a CASET/RASET/RAMWR setup, a queued transaction and a render
+ * pass. Two areas are merged when their bounding box, split into draw
+ * buffer chunks, costs less than refreshing both. The merged area is kept
+ * at the higher index: LVGL has already picked the last unjoined area to
+ * flag the end of the frame.
+ *
+ * @return Number of merges
+ */
+static uint32_t lvgl_merge_areas(lvgl_driver_t *driver, lv_disp_t *disp)
+{
+    st7789_device_t *lcd = driver->config.lcd_device;
+    if (driver->config.merge_flush_cost_us == 0 || driver->disp_drv.full_refresh) {
+        return 0;
+    }
+
+    // Express the fixed cost in pixels at the current SPI clock
+    uint32_t flush_cost_px = (uint32_t)((uint64_t)driver->config.merge_flush_cost_us *
+                                        lcd->config.pixel_clock_hz /
+                                        (lcd->config.bits_per_pixel * 1000000ULL));
+    uint32_t buf_size = driver->buf_size;
+    uint32_t merges = 0;
+    bool merged;
+
+    do {
+        merged = false;
+        for (uint16_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) {
+                continue;
+            }
+            for (uint16_t j = i + 1; j < disp->inv_p; j++) {
+                if (disp->inv_area_joined[j]) {
+                    continue;
+                }
+
+                lv_area_t joined;
+                _lv_area_join(&joined, &disp->inv_areas[i], &disp->inv_areas[j]);
+                if (area_refresh_cost(&joined, buf_size, flush_cost_px) <=
+                    area_refresh_cost(&disp->inv_areas[i], buf_size, flush_cost_px) +
+                    area_refresh_cost(&disp->inv_areas[j], buf_size, flush_cost_px)) {
+                    lv_area_copy(&disp->inv_areas[j], &joined);
+                    disp->inv_area_joined[i] = 1;
+                    merges++;
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    } while (merged);   // A grown area may now pay off with an earlier one
+
+    return merges;
+}
+
+/**
+ * @brief Render start: merge areas, then open a metrics frame
+ */
+static void lvgl_render_start_callback(lv_disp_drv_t *drv)
+{
+    lvgl_driver_t *driver = (lvgl_driver_t *)drv->user_data;
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    if (disp == NULL) {
+        return;
+    }
+
+    driver->frame_merges = lvgl_merge_areas(driver, disp);
+
+    // Something was invalidated: back to full panel mode before any pixel goes out
+    driver->last_frame_us = esp_timer_get_time();
+    if (driver->panel_idle) {
+        lvgl_panel_set_idle(driver, false);
+    }
+
+#if CONFIG_LVGL_DRIVER_METRICS
+    driver->frame_start_us = esp_timer_get_time();
+    driver->frame_wait_us = 0;
+    driver->frame_flushes = 0;
+    driver->frame_bytes = 0;
+    driver->frame_areas = 0;
+    driver->metrics.merges += driver->frame_merges;
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+        if (!disp->inv_area_joined[i]) {
+            driver->frame_areas++;
+        }
+    }
+#endif
+}
+
+/******************************************************************************
+ * Panel Power Saving
+ ******************************************************************************/
+
+/**
+ * @brief Switch the panel between its full and its power saving state
+ *
+ * Called with the LVGL lock held. The commands queue behind any flush
+ * still on the wire, so the last frame lands before the panel slows down.
+ */
+static void lvgl_panel_set_idle(lvgl_driver_t *driver, bool idle)
+{
+    const lvgl_config_t *cfg = &driver->config;
+    st7789_device_t *lcd = cfg->lcd_device;
+    esp_err_t ret = ESP_OK;
+
+    if (cfg->idle_frame_rate != 0) {
+        ret = st7789_set_frame_rate(lcd, idle ? cfg->idle_frame_rate : ST7789_FRAME_RATE_HZ);
+    }
+    if (ret == ESP_OK && cfg->idle_8_color) {
+        ret = st7789_set_idle_mode(lcd, idle);
+    }
+    if (ret == ESP_OK && cfg->idle_partial_height != 0 && cfg->rotation == 0) {
+        uint16_t first = lcd->config.offset_y + cfg->idle_partial_top;
+        ret = st7789_set_partial(lcd, idle, first, first + cfg->idle_partial_height - 1);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Panel power state change failed: %s", esp_err_to_name(ret));
+    }
+
+    // Marked even on failure: retrying every pass would flood the bus
+    driver->panel_idle = idle;
+    if (idle) {
+        driver->panel_idle_entries++;
+    }
+    ESP_LOGD(TAG, "Panel %s", idle ? "idle" : "active");
+}
+
+/**
+ * @brief Enter the power saving state after idle_timeout_ms without a frame
+ */
+static void lvgl_panel_idle_check(lvgl_driver_t *driver)
+{
+    if (driver->panel_idle || driver->config.idle_timeout_ms == 0) {
+        return;
+    }
+    if (esp_timer_get_time() - driver->last_frame_us >= driver->config.idle_timeout_ms * 1000LL) {
+        lvgl_panel_set_idle(driver, true);
+    }
+}
+
+/******************************************************************************
+ * Flush Pipeline Metrics
+ ******************************************************************************/
+
+lvgl_metrics_stat_t lvgl_metrics_hist_stat(const lvgl_metrics_hist_t *hist)
+{
+    lvgl_metrics_stat_t stat = {0};
+    if (hist == NULL || hist->count == 0) {
+        return stat;
+    }
+
+    stat.min = hist->min;
+    stat.max = hist->max;
+    stat.avg = (uint32_t)(hist->sum / hist->count);
+
+    // Smallest bucket holding at least 99% of the samples
+    uint32_t target = hist->count - hist->count / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < LVGL_METRICS_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= target) {
+            if (i < 4) {
+                stat.p99 = i;
+            } else {
+                uint32_t shift = i / 4 - 1;
+                stat.p99 = ((4 + i % 4 + 1) << shift) - 1;
+            }
+            break;
+        }
+    }
+    if (stat.p99 > stat.max) {
+        stat.p99 = stat.max;
+    }
+    return stat;
+}
+
+#if CONFIG_LVGL_DRIVER_METRICS
+
+static void metrics_hist_add(lvgl_metrics_hist_t *hist, uint32_t value)
+{
+    uint32_t idx = value;
+    if (value >= 4) {
+        uint32_t msb = 31 - __builtin_clz(value);
+        idx = (msb - 1) * 4 + ((value >> (msb - 2)) & 3);
+        if (idx >= LVGL_METRICS_HIST_BUCKETS) {
+            idx = LVGL_METRICS_HIST_BUCKETS - 1;
+        }
+    }
+
+    hist->buckets[idx]++;
+    if (hist->count == 0 || value < hist->min) {
+        hist->min = value;
+    }
+    if (value > hist->max) {
+        hist->max = value;
+    }
+    hist->sum += value;
+    hist->count++;
+}
+
+/**
+ * @brief Monitor: close the frame and add it to the histograms
+ */
+static void lvgl_monitor_callback(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    lvgl_driver_t *driver = (lvgl_driver_t *)drv->user_data;
+    lvgl_metrics_t *m = &driver->metrics;
+    uint32_t frame_us = (uint32_t)(esp_timer_get_time() - driver->frame_start_us);
+    uint32_t wait_us = driver->frame_wait_us < frame_us ? driver->frame_wait_us : frame_us;
+
+    m->frames++;
+    m->flushes += driver->frame_flushes;
+    m->bytes += driver->frame_bytes;
+    metrics_hist_add(&m->frame_us, frame_us);
+    metrics_hist_add(&m->render_us, frame_us - wait_us);
+    metrics_hist_add(&m->dma_wait_us, wait_us);
+    metrics_hist_add(&m->flushes_per_frame, driver->frame_flushes);
+    metrics_hist_add(&m->bytes_per_frame, driver->frame_bytes);
+    metrics_hist_add(&m->areas_per_frame, driver->frame_areas);
+}
+
+#endif
+
+esp_err_t lvgl_driver_get_metrics(lvgl_driver_t *driver, lvgl_metrics_t *metrics)
+{
+#if CONFIG_LVGL_DRIVER_METRICS
+    if (driver == NULL || metrics == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!lvgl_driver_lock(driver, -1)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    memcpy(metrics, &driver->metrics, sizeof(lvgl_metrics_t));
+    metrics->elapsed_us = esp_timer_get_time() - driver->metrics_start_us;
+    metrics->task_wakeups = driver->task_wakeups - driver->metrics_task_wakeups;
+    metrics->tick_wakeups = driver->tick_wakeups - driver->metrics_tick_wakeups;
+    xSemaphoreGiveRecursive(driver->lock);  // Nothing changed, don't wake the render task
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void lvgl_driver_reset_metrics(lvgl_driver_t *driver)
+{
+#if CONFIG_LVGL_DRIVER_METRICS
+    if (driver == NULL) {
+        return;
+    }
+    bool locked = lvgl_driver_lock(driver, -1);
+    memset(&driver->metrics, 0, sizeof(lvgl_metrics_t));
+    driver->metrics_start_us = esp_timer_get_time();
+    driver->metrics_task_wakeups = driver->task_wakeups;
+    driver->metrics_tick_wakeups = driver->tick_wakeups;
+    if (locked) {
+        xSemaphoreGiveRecursive(driver->lock);
+    }
+#endif
+}
+
+void lvgl_driver_dump_metrics(lvgl_driver_t *driver)
+{
+    static lvgl_metrics_t snapshot;     // Too large for a small console task stack
+    esp_err_t ret = lvgl_driver_get_metrics(driver, &snapshot);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Metrics not available: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    const struct {
+        const char *name;
+        const lvgl_metrics_hist_t *hist;
+    } rows[] = {
+        { "frame us",       &snapshot.frame_us },
+        { "render us",      &snapshot.render_us },
+        { "dma wait us",    &snapshot.dma_wait_us },
+        { "flushes/frame",  &snapshot.flushes_per_frame },
+        { "bytes/frame",    &snapshot.bytes_per_frame },
+        { "areas/frame",    &snapshot.areas_per_frame },
+    };
+
+    // Wakeups per second, one decimal
+    uint32_t elapsed_ms = snapshot.elapsed_us > 0 ? (uint32_t)(snapshot.elapsed_us / 1000) : 1;
+    uint32_t task_rate = (uint32_t)((uint64_t)snapshot.task_wakeups * 10000 / elapsed_ms);
+    uint32_t tick_rate = (uint32_t)((uint64_t)snapshot.tick_wakeups * 10000 / elapsed_ms);
+
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "Wakeups in %lu ms: render task %lu (%lu.%lu/s), tick timer %lu (%lu.%lu/s)",
+             (unsigned long)elapsed_ms,
+             (unsigned long)snapshot.task_wakeups, (unsigned long)(task_rate / 10), (unsigned long)(task_rate % 10),
+             (unsigned long)snapshot.tick_wakeups, (unsigned long)(tick_rate / 10), (unsigned long)(tick_rate % 10));
+    ESP_LOGI(TAG, "Frames: %lu, flushes: %lu, bytes: %llu, merges: %lu",
+             (unsigned long)snapshot.frames, (unsigned long)snapshot.flushes,
+             (unsigned long long)snapshot.bytes, (unsigned long)snapshot.merges);
+    ESP_LOGI(TAG, "%-14s %8s %8s %8s %8s", "", "min", "avg", "p99", "max");
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+        lvgl_metrics_stat_t stat = lvgl_metrics_hist_stat(rows[i].hist);
+        ESP_LOGI(TAG, "%-14s %8lu %8lu %8lu %8lu", rows[i].name,
+                 (unsigned long)stat.min, (unsigned long)stat.avg,
+                 (unsigned long)stat.p99, (unsigned long)stat.max);
+    }
+    ESP_LOGI(TAG, "========================================");
 }
 
 /******************************************************************************
  * Callback Functions
  ******************************************************************************/
 
+#if !CONFIG_LV_TICK_CUSTOM
 void lvgl_tick_callback(void *arg)
 {
     lvgl_driver_t *driver = (lvgl_driver_t *)arg;
     if (driver != NULL) {
+        driver->tick_wakeups++;
         lv_tick_inc(driver->config.tick_period_ms);
     }
 }
+#endif
+
+/**
+ * @brief Find the frame memory rows of a run of flushed screen rows
+ *
+ * @param y First screen row of the run
+ * @param y_end Last screen row of the flush
+ * @param mem_y Returned frame memory row of y (without offset_y)
+ * @return Last screen row stored right below mem_y's row, at most y_end
+ */
+static int lvgl_flush_segment(const lvgl_driver_t *driver, int y, int y_end, int *mem_y)
+{
+    int top = driver->scroll_top;
+    int h = driver->scroll_height;
+
+    *mem_y = y;
+    if (h == 0 || y >= top + h) {
+        return y_end;
+    }
+    if (y < top) {
+        return LV_MIN(y_end, top - 1);
+    }
+
+    int r = (y - top + driver->scroll_offset) % h;
+    *mem_y = top + r;
+    return LV_MIN(y_end, y + (h - r) - 1);
+}
 
 void lvgl_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
@@ -296,17 +1179,94 @@ void lvgl_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *
         return;
     }
 
+    // The panel IO is gone (failed pixel clock restore): drop the frame,
+    // no transfer done callback would ever release the buffer
+    if (!lcd->is_initialized) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
     // Calculate display coordinates with offset
     int x1 = area->x1 + lcd->config.offset_x;
-    int y1 = area->y1 + lcd->config.offset_y;
     int x2 = area->x2 + lcd->config.offset_x;
-    int y2 = area->y2 + lcd->config.offset_y;
+    int w = lv_area_get_width(area);
+
+    // Rows that stay contiguous in frame memory go out as one draw_bitmap;
+    // only a flush crossing the scroll region edges or its wrap is split
+    uint32_t parts = 0;
+    int mem_y;
+    for (int y = area->y1; y <= area->y2; y = lvgl_flush_segment(driver, y, area->y2, &mem_y) + 1) {
+        parts++;
+    }
+    __atomic_store_n(&driver->flush_parts, parts, __ATOMIC_RELAXED);
 
-    // Draw bitmap to LCD panel
-    esp_lcd_panel_draw_bitmap(lcd->panel_handle, x1, y1, x2 + 1, y2 + 1, color_map);
+    size_t conv_bytes = 0;
+    uint32_t sent = 0;
+    for (int y = area->y1; y <= area->y2; ) {
+        int end = lvgl_flush_segment(driver, y, area->y2, &mem_y);
+        const lv_color_t *src = color_map + (y - area->y1) * w;
+        int y1 = mem_y + lcd->config.offset_y;
+        int y2 = y1 + (end - y);
 
-    // Notify LVGL that flushing is done
-    lv_disp_flush_ready(drv);
+        // 12-bit mode: pack into the staging buffer. LVGL starts the next flush
+        // only after lvgl_trans_done_callback(), so one staging buffer is enough.
+        const void *data = src;
+        if (driver->color_depth == 12) {
+            data = driver->conv_buf + conv_bytes;
+            conv_bytes += pixel_565_to_444(driver->conv_buf + conv_bytes, (const uint16_t *)src, (end - y + 1) * w);
+        }
+
+        // Queue bitmap to LCD panel. The DMA keeps reading the data after this
+        // returns; lvgl_trans_done_callback() releases the buffer to LVGL.
+        esp_err_t ret = esp_lcd_panel_draw_bitmap(lcd->panel_handle, x1, y1, x2 + 1, y2 + 1, data);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Draw bitmap failed: %s", esp_err_to_name(ret));
+            // Parts already queued may still complete; the last one out releases the buffer
+            if (__atomic_sub_fetch(&driver->flush_parts, parts - sent, __ATOMIC_ACQ_REL) == 0) {
+                lv_disp_flush_ready(drv);
+            }
+            return;
+        }
+        sent++;
+        y = end + 1;
+    }
+
+#if CONFIG_LVGL_DRIVER_METRICS
+    driver->frame_flushes++;
+    driver->frame_bytes += driver->color_depth == 12 ? conv_bytes : lv_area_get_size(area) * sizeof(lv_color_t);
+#endif
+}
+
+void lvgl_flush_wait_callback(lv_disp_drv_t *drv)
+{
+    lvgl_driver_t *driver = (lvgl_driver_t *)drv->user_data;
+
+    // LVGL loops on the flushing flag; sleep until the transfer done ISR
+    // signals. The timeout only guards against a lost notification.
+#if CONFIG_LVGL_DRIVER_METRICS
+    int64_t start_us = esp_timer_get_time();
+    xSemaphoreTake(driver->flush_done_sem, pdMS_TO_TICKS(LVGL_FLUSH_WAIT_TIMEOUT_MS));
+    driver->frame_wait_us += (uint32_t)(esp_timer_get_time() - start_us);
+#else
+    xSemaphoreTake(driver->flush_done_sem, pdMS_TO_TICKS(LVGL_FLUSH_WAIT_TIMEOUT_MS));
+#endif
+}
+
+/**
+ * @brief Color transfer done (ISR context): hand the buffer back to LVGL
+ */
+static bool lvgl_trans_done_callback(void *user_ctx)
+{
+    lvgl_driver_t *driver = (lvgl_driver_t *)user_ctx;
+    BaseType_t need_yield = pdFALSE;
+
+    // A flush split at the scroll region is done with its last part
+    if (__atomic_load_n(&driver->flush_parts, __ATOMIC_RELAXED) == 0 ||
+        __atomic_sub_fetch(&driver->flush_parts, 1, __ATOMIC_ACQ_REL) == 0) {
+        lv_disp_flush_ready(&driver->disp_drv);
+    }
+    xSemaphoreGiveFromISR(driver->flush_done_sem, &need_yield);
+    return need_yield == pdTRUE;
 }
 
 void lvgl_rotation_callback(lv_disp_drv_t *drv)
@@ -11,7 +11,13 @@
  * - Configurable buffer allocation (internal RAM / SPIRAM)
  * - Double/single buffer support
  * - Display rotation and mirroring
- * - Automatic tick timer management
+ * - Tickless timekeeping (LV_TICK_CUSTOM), periodic tick timer as fallback
+ * - Merging of nearby dirty areas by an SPI cost model
+ * - Optional draw buffer calibration at init
+ * - 12-bit (RGB444) transfer mode, switchable per screen
+ * - Hardware vertical scrolling of a screen band, redrawing only new rows
+ * - Panel power saving (frame rate, idle, partial mode) while the UI is static
+ * - Optional flush pipeline metrics (CONFIG_LVGL_DRIVER_METRICS)
  * - Clean object lifecycle (create/init/destroy)
  */
 
@@ -26,6 +32,7 @@ extern "C" {
 #include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_timer.h"
 #include "esp_err.h"
 #include "esp_log.h"
@@ -39,7 +46,19 @@ extern "C" {
  ******************************************************************************/
 
 #define LVGL_DEFAULT_BUF_LINES      20      // Default buffer size (lines)
-#define LVGL_TICK_PERIOD_MS         2       // LVGL tick period in milliseconds
+#define LVGL_TICK_PERIOD_MS         2       // Tick timer period, only used without CONFIG_LV_TICK_CUSTOM
+#define LVGL_FLUSH_WAIT_TIMEOUT_MS  20      // Re-check the flush state at least this often
+#define LVGL_TASK_STACK_SIZE        (6 * 1024)
+#define LVGL_TASK_PRIORITY          2
+#define LVGL_TASK_CORE              0       // ESP32-C6 has a single core
+#define LVGL_TASK_MAX_SLEEP_MS      500     // Upper bound on sleep when no timer is due
+#define LVGL_METRICS_HIST_BUCKETS   64      // 4 buckets per power of two, values up to 131071
+#define LVGL_MERGE_FLUSH_COST_US    150     // Fixed cost of one flush: window setup, queueing, render pass
+#define LVGL_CALIB_FRAMES           8       // Measured frames per buffer setting
+#define LVGL_CALIB_LABELS           4       // Labels updated by the small-area frames
+#define LVGL_CALIB_TOLERANCE_PCT    5       // Prefer less RAM if within this much of the fastest
+#define LVGL_PANEL_IDLE_TIMEOUT_MS  3000    // No frame for this long: panel power saving
+#define LVGL_PANEL_IDLE_FRAME_RATE  39      // Panel refresh rate while static (Hz, slowest the ST7789 offers)
 
 /******************************************************************************
  * Type Definitions - Object-Oriented Structures
@@ -68,18 +87,84 @@ typedef struct {
     uint16_t buf_lines;                 // Buffer size in lines (e.g., 20)
     bool use_double_buffer;             // Use double buffering
     lvgl_buffer_alloc_t buf_alloc;      // Buffer allocation strategy
+    bool calibrate_buffers;             // Measure buffer settings at init, overrides buf_lines/use_double_buffer
+    size_t calib_ram_budget;            // Max bytes for both buffers while calibrating (0 = 1/4 of free heap)
 
     // Display settings
     bool full_refresh;                  // Always redraw entire screen
     uint8_t rotation;                   // Initial rotation (0/90/180/270)
+    uint16_t merge_flush_cost_us;       // Fixed cost of one flush for area merging (0 = no merging)
 
     // Associated LCD device
     st7789_device_t *lcd_device;        // ST7789 LCD driver instance
 
     // Tick timer settings
-    uint16_t tick_period_ms;            // Tick period in milliseconds
+    uint16_t tick_period_ms;            // Tick period in milliseconds (without CONFIG_LV_TICK_CUSTOM)
+
+    // Render task settings
+    bool use_render_task;               // Run LVGL in a dedicated task (else call lvgl_driver_task_handler)
+    uint32_t task_stack_size;           // Render task stack size in bytes
+    UBaseType_t task_priority;          // Render task priority
+    BaseType_t task_core;               // Core the render task is pinned to (tskNO_AFFINITY = any)
+    uint32_t task_max_sleep_ms;         // Longest sleep when LVGL reports no pending timer
+
+    // Panel power saving while no frame is rendered, undone at the next render start
+    uint32_t idle_timeout_ms;           // Time without a frame before saving (0 = off)
+    uint8_t idle_frame_rate;            // Panel refresh rate while idle (Hz, 0 = keep)
+    bool idle_8_color;                  // 8-color idle mode (IDMON), only for screens in primary colors
+    uint16_t idle_partial_top;          // Partial mode: first screen row kept lit
+    uint16_t idle_partial_height;       // Partial mode: rows kept lit, rotation 0 only (0 = off)
 } lvgl_config_t;
 
+/**
+ * @brief Histogram of one per-frame quantity
+ *
+ * Buckets are log-linear: values 0-3 get their own bucket, above that every
+ * power of two is split into 4 buckets, so percentiles are within 25%.
+ * Larger values land in the last bucket; min/max/sum stay exact.
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t buckets[LVGL_METRICS_HIST_BUCKETS];
+} lvgl_metrics_hist_t;
+
+/**
+ * @brief Summary of a histogram
+ */
+typedef struct {
+    uint32_t min;
+    uint32_t avg;
+    uint32_t p99;                       // Upper bound of the 99th percentile bucket
+    uint32_t max;
+} lvgl_metrics_stat_t;
+
+/**
+ * @brief Flush pipeline metrics
+ *
+ * A frame runs from LVGL's render start to its monitor callback. Time
+ * blocked in the flush wait callback is DMA wait, the rest is rendering.
+ * High render time means the UI is CPU-bound, high DMA wait means it is
+ * SPI-bound.
+ */
+typedef struct {
+    int64_t elapsed_us;                 // Time since the last reset
+    uint32_t task_wakeups;              // Render task passes
+    uint32_t tick_wakeups;              // Tick timer callbacks (0 with CONFIG_LV_TICK_CUSTOM)
+    uint32_t frames;                    // Frames refreshed
+    uint32_t flushes;                   // Flush callbacks (draw_bitmap calls)
+    uint64_t bytes;                     // Pixel bytes sent to the LCD
+    uint32_t merges;                    // Area pairs merged by the cost model
+    lvgl_metrics_hist_t frame_us;       // Whole refresh
+    lvgl_metrics_hist_t render_us;      // Refresh minus DMA wait
+    lvgl_metrics_hist_t dma_wait_us;    // Blocked waiting for the transfer done ISR
+    lvgl_metrics_hist_t flushes_per_frame;
+    lvgl_metrics_hist_t bytes_per_frame;
+    lvgl_metrics_hist_t areas_per_frame; // Invalidated areas after joining
+} lvgl_metrics_t;
+
 /**
  * @brief LVGL Driver Device Object
  *
@@ -99,8 +184,48 @@ typedef struct {
     lv_color_t *buf2;
     size_t buf_size;                    // Buffer size in pixels
 
-    // Tick timer
+    // 12-bit transfer mode: flushes are packed into conv_buf first
+    uint8_t color_depth;                // Bits per pixel on the wire (16 or 12)
+    uint8_t *conv_buf;                  // RGB444 staging buffer (DMA), allocated on first use
+
+    // Hardware scroll region (rotation 0 only): screen row top + r is stored
+    // in frame memory row top + (r + scroll_offset) % scroll_height
+    int16_t scroll_top;                 // First screen row of the region
+    int16_t scroll_height;              // Rows in the region, 0 = hardware scrolling off
+    int16_t scroll_offset;              // Rows the content has moved up since the region was set
+    uint32_t flush_parts;               // draw_bitmap calls of the flush in flight (atomic)
+
+    // Panel power saving
+    int64_t last_frame_us;              // Last render start
+    bool panel_idle;                    // Panel is in its power saving state
+    uint32_t panel_idle_entries;        // Times the power saving state was entered
+
+    // Tick timer (NULL with CONFIG_LV_TICK_CUSTOM)
     esp_timer_handle_t tick_timer;
+    uint32_t tick_wakeups;              // Tick timer callbacks since init
+
+    // Flush completion (given from the color transfer done ISR)
+    SemaphoreHandle_t flush_done_sem;
+
+    // Render task
+    TaskHandle_t render_task;
+    SemaphoreHandle_t lock;             // Recursive mutex guarding all LVGL calls
+    volatile bool task_running;
+    uint32_t task_wakeups;              // Render task passes since init (idle wakeup count)
+    uint32_t frame_merges;              // Areas merged at the last render start
+
+#if CONFIG_LVGL_DRIVER_METRICS
+    // Flush pipeline metrics (updated by the render task under the lock)
+    lvgl_metrics_t metrics;
+    int64_t metrics_start_us;           // Last reset, with the wakeup counters at that time
+    uint32_t metrics_task_wakeups;
+    uint32_t metrics_tick_wakeups;
+    int64_t frame_start_us;
+    uint32_t frame_wait_us;
+    uint32_t frame_flushes;
+    uint32_t frame_bytes;
+    uint32_t frame_areas;
+#endif
 
     // State
     bool is_initialized;
@@ -133,7 +258,7 @@ lvgl_driver_t* lvgl_driver_create(const lvgl_config_t *config);
  * - Initializes LVGL library
  * - Allocates display buffers
  * - Registers display driver
- * - Starts tick timer
+ * - Starts tick timer (only without CONFIG_LV_TICK_CUSTOM)
  *
  * @param driver Pointer to driver object
  * @return ESP_OK on success, error code otherwise
@@ -157,6 +282,59 @@ esp_err_t lvgl_driver_destroy(lvgl_driver_t *driver);
  */
 esp_err_t lvgl_driver_set_rotation(lvgl_driver_t *driver, uint16_t rotation);
 
+/**
+ * @brief Set the color depth sent to the LCD
+ *
+ * LVGL keeps rendering RGB565. At 12 bpp every flush is packed to RGB444
+ * (two pixels in three bytes) before the transfer: 25% fewer bytes on the
+ * SPI link for 4 bits per channel, visible as banding in gradients. Meant
+ * to be switched per screen, e.g. to 12 while an animation or video runs
+ * and back to 16 for static content. Waits for the flush in flight.
+ *
+ * @param driver Pointer to driver object
+ * @param bits_per_pixel 16 or 12
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the staging buffer can't be allocated
+ */
+esp_err_t lvgl_driver_set_color_depth(lvgl_driver_t *driver, uint8_t bits_per_pixel);
+
+/**
+ * @brief Set up a band of the screen for hardware vertical scrolling
+ *
+ * Programs the ST7789 scroll area (VSCRDEF) to the screen rows
+ * top .. top + height - 1. Rows above and below stay fixed. Only for
+ * rotation 0: the controller scrolls frame memory rows, which are screen
+ * columns when rotated. Flushes into the band are remapped to the rotated
+ * frame memory rows from then on.
+ *
+ * @param driver Pointer to driver object
+ * @param top First screen row of the band
+ * @param height Rows in the band, 0 to switch hardware scrolling off
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED when rotated or with full_refresh
+ */
+esp_err_t lvgl_driver_set_scroll_area(lvgl_driver_t *driver, uint16_t top, uint16_t height);
+
+/**
+ * @brief Scroll an object that fills the scroll band, redrawing only the new rows
+ *
+ * Scrolls obj by dy pixels (dy > 0 moves the content up, like a console
+ * printing a line) and moves the panel's scroll start (VSCSAD) along with
+ * it. Of the band only the dy rows that came into view are rendered and
+ * sent instead of the whole band. The caller must hold the LVGL lock.
+ *
+ * obj has to cover exactly the band, full width, with nothing drawn on top
+ * of it and no scrollbar (LV_SCROLLBAR_MODE_OFF): what LVGL invalidates
+ * inside the band during the scroll is dropped, the rest (e.g. a label a
+ * scroll handler updates elsewhere) is kept. Until the next refresh the
+ * new rows show what scrolled out at the other edge; call lv_refr_now() to
+ * close that gap.
+ *
+ * @param driver Pointer to driver object
+ * @param obj Object filling the band
+ * @param dy Pixels to scroll the content up (negative: down)
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if no band is set
+ */
+esp_err_t lvgl_driver_scroll(lvgl_driver_t *driver, lv_obj_t *obj, lv_coord_t dy);
+
 /**
  * @brief Get current LVGL display object
  *
@@ -168,23 +346,94 @@ lv_disp_t* lvgl_driver_get_display(lvgl_driver_t *driver);
 /**
  * @brief Task handler - must be called periodically
  *
- * Call this in your main loop or dedicated task.
+ * Call this in your main loop or dedicated task when use_render_task is
+ * disabled. With the render task running this only wakes it.
  * Recommended interval: 5-10ms
  *
  * @param driver Pointer to driver object (can be NULL if using legacy API)
  */
 void lvgl_driver_task_handler(lvgl_driver_t *driver);
 
+/**
+ * @brief Take the LVGL lock
+ *
+ * Any task other than the render task must hold the lock while calling
+ * LVGL functions. The lock is recursive.
+ *
+ * @param driver Pointer to driver object
+ * @param timeout_ms Timeout in milliseconds, -1 to wait forever
+ * @return true if the lock was taken
+ */
+bool lvgl_driver_lock(lvgl_driver_t *driver, int timeout_ms);
+
+/**
+ * @brief Release the LVGL lock
+ *
+ * Also wakes the render task, so changes made under the lock are drawn
+ * without waiting for the next LVGL timer.
+ *
+ * @param driver Pointer to driver object
+ */
+void lvgl_driver_unlock(lvgl_driver_t *driver);
+
+/**
+ * @brief Wake the render task
+ *
+ * Makes the render task run lv_timer_handler() now instead of at the next
+ * LVGL deadline, e.g. after input arrived. Safe to call from any task.
+ *
+ * @param driver Pointer to driver object
+ */
+void lvgl_driver_wake(lvgl_driver_t *driver);
+
+/**
+ * @brief Copy the flush pipeline metrics
+ *
+ * Takes the LVGL lock, so the snapshot is consistent.
+ *
+ * @param driver Pointer to driver object
+ * @param metrics Output snapshot
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_LVGL_DRIVER_METRICS
+ */
+esp_err_t lvgl_driver_get_metrics(lvgl_driver_t *driver, lvgl_metrics_t *metrics);
+
+/**
+ * @brief Clear the flush pipeline metrics
+ *
+ * @param driver Pointer to driver object
+ */
+void lvgl_driver_reset_metrics(lvgl_driver_t *driver);
+
+/**
+ * @brief Print the flush pipeline metrics (min/avg/p99/max) and the
+ *        wakeup rates since the last reset to the log
+ *
+ * @param driver Pointer to driver object
+ */
+void lvgl_driver_dump_metrics(lvgl_driver_t *driver);
+
+/**
+ * @brief Summarize a metrics histogram
+ *
+ * @param hist Histogram
+ * @return min/avg/p99/max, all zero for an empty histogram
+ */
+lvgl_metrics_stat_t lvgl_metrics_hist_stat(const lvgl_metrics_hist_t *hist);
+
 /******************************************************************************
  * Callback Functions (Internal)
  ******************************************************************************/
 
+#if !CONFIG_LV_TICK_CUSTOM
 /**
  * @brief Tick timer callback
  *
+ * lv_tick_inc() only exists without LV_TICK_CUSTOM.
+ *
  * @param arg Timer argument (driver object)
  */
 void lvgl_tick_callback(void *arg);
+#endif
 
 /**
  * @brief Display flush callback
@@ -195,6 +444,16 @@ void lvgl_tick_callback(void *arg);
  */
 void lvgl_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
 
+/**
+ * @brief Flush wait callback
+ *
+ * Called by LVGL while a flush is in progress; blocks on the transfer
+ * done semaphore instead of busy-polling.
+ *
+ * @param drv LVGL display driver
+ */
+void lvgl_flush_wait_callback(lv_disp_drv_t *drv);
+
 /**
  * @brief Display rotation update callback
  *
@@ -217,10 +476,10 @@ lvgl_config_t lvgl_config = lvgl_get_default_config(lcd);
 lvgl_driver_t *lvgl = lvgl_driver_create(&lvgl_config);
 lvgl_driver_init(lvgl);
 
-// In main loop:
-while (1) {
-    lvgl_driver_task_handler(lvgl);
-    vTaskDelay(pdMS_TO_TICKS(10));
+// LVGL runs in its own task; other tasks lock around LVGL calls:
+if (lvgl_driver_lock(lvgl, -1)) {
+    lv_label_set_text(label, "Hello");
+    lvgl_driver_unlock(lvgl);
 }
 
 // Example 2: Custom configuration with SPIRAM buffers
@@ -241,6 +500,30 @@ lvgl_driver_init(lvgl);
 // Example 3: Runtime rotation and backlight control
 lvgl_driver_set_rotation(lvgl, 180);        // Flip display
 st7789_backlight_fade(lcd, 50, 1000);       // Fade to 50% in 1 second
+
+// Example 4: Render-bound or SPI-bound? (CONFIG_LVGL_DRIVER_METRICS=y)
+lvgl_metrics_t m;
+if (lvgl_driver_get_metrics(lvgl, &m) == ESP_OK) {
+    lvgl_metrics_stat_t render = lvgl_metrics_hist_stat(&m.render_us);
+    lvgl_metrics_stat_t wait = lvgl_metrics_hist_stat(&m.dma_wait_us);
+    printf("render p99 %lu us, dma wait p99 %lu us\n", render.p99, wait.p99);
+}
+
+// Example 5: Console below a fixed 40-row header, scrolled in hardware
+lv_obj_t *console = lv_obj_create(lv_scr_act());
+lv_obj_remove_style_all(console);                   // No border or background that would scroll along
+lv_obj_set_pos(console, 0, 40);
+lv_obj_set_size(console, LV_PCT(100), 280);
+lv_obj_set_scrollbar_mode(console, LV_SCROLLBAR_MODE_OFF);
+lvgl_driver_set_scroll_area(lvgl, 40, 280);
+if (lvgl_driver_lock(lvgl, -1)) {
+    lv_obj_t *line = lv_label_create(console);      // One label per line, below the visible part
+    lv_label_set_text(line, "new line");
+    lv_obj_set_y(line, next_y);
+    next_y += line_height;
+    lvgl_driver_scroll(lvgl, console, line_height); // Sends line_height rows, not 280
+    lvgl_driver_unlock(lvgl);
+}
 */
 
 #ifdef __cplusplus
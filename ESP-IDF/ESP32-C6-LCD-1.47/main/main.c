@@ -1,11 +1,28 @@
+#include <stdlib.h>
+#include <string.h>
 #include "ST7789.h"
 #include "SD_SPI.h"
 #include "RGB.h"
 #include "Wireless.h"
 #include "LVGL_Example.h"
+#if CONFIG_LCD_DRIVER_CONSOLE
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+#include "driver/usb_serial_jtag.h"
+#include "esp_vfs_usb_serial_jtag.h"
+#else
+#include "driver/uart.h"
+#include "esp_vfs_dev.h"
+#endif
+#endif
 
 static const char *TAG = "MAIN";
 
+#if CONFIG_LCD_INIT_IN_BACKGROUND
+#define LCD_INIT_MODE   "in background"
+#else
+#define LCD_INIT_MODE   "inline"
+#endif
+
 // Global driver instances (using new OOP API)
 static st7789_device_t *lcd_device = NULL;
 static lvgl_driver_t *lvgl_driver = NULL;
@@ -34,6 +51,113 @@ static void spi_bus_init(void)
     }
 }
 
+#if CONFIG_LCD_DRIVER_CONSOLE
+/**
+ * @brief Serial command task
+ *
+ * Reads lines from the console: "pclk" prints the LCD pixel clock,
+ * "pclk <hz>" changes it and "pclk sweep" times full frames at
+ * ST7789_SWEEP_CLOCKS_HZ. "depth 12" / "depth 16" switches the LCD transfer
+ * color depth. With CONFIG_LVGL_DRIVER_METRICS "metrics" dumps the flush
+ * pipeline metrics and the wakeup rates, "metrics reset" clears them.
+ * With the virtual panel "frame" writes the screen to the SD card as a
+ * PPM image and prints the modeled bus time.
+ */
+static void console_task(void *arg)
+{
+    char line[32];
+    size_t len = 0;
+
+    // Without a driver the console VFS never blocks and getchar() returns
+    // EOF at once; with one it waits in the driver's read until a byte arrives
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+    usb_serial_jtag_driver_config_t jtag_config = USB_SERIAL_JTAG_DRIVER_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(usb_serial_jtag_driver_install(&jtag_config));
+    esp_vfs_usb_serial_jtag_use_driver();
+#else
+    ESP_ERROR_CHECK(uart_driver_install(CONFIG_ESP_CONSOLE_UART_NUM, 256, 0, 0, NULL, 0));
+    esp_vfs_dev_uart_use_driver(CONFIG_ESP_CONSOLE_UART_NUM);
+#endif
+    setvbuf(stdin, NULL, _IONBF, 0);
+
+    while (1) {
+        int c = getchar();
+        if (c == EOF) {
+            clearerr(stdin);
+            continue;
+        }
+
+        if (c != '\r' && c != '\n') {
+            if (len < sizeof(line) - 1) {
+                line[len++] = (char)c;
+            }
+            continue;
+        }
+
+        line[len] = '\0';
+        if (len == 0) {
+            continue;
+#if CONFIG_LVGL_DRIVER_METRICS
+        } else if (strcmp(line, "metrics") == 0) {
+            lvgl_driver_dump_metrics(lvgl_driver);
+        } else if (strcmp(line, "metrics reset") == 0) {
+            lvgl_driver_reset_metrics(lvgl_driver);
+#if CONFIG_LCD_VIRTUAL_PANEL
+            esp_lcd_panel_virtual_reset_stats(lcd_device->panel_handle);
+#endif
+            ESP_LOGI(TAG, "Metrics cleared");
+#endif
+#if CONFIG_LCD_VIRTUAL_PANEL
+        } else if (strcmp(line, "frame") == 0) {
+            esp_lcd_panel_virtual_stats_t stats;
+            esp_lcd_panel_virtual_get_stats(lcd_device->panel_handle, &stats);
+            ESP_LOGI(TAG, "Virtual panel: %lu draws, %llu pixel bytes, %llu us bus time",
+                     (unsigned long)stats.draws, (unsigned long long)stats.pixel_bytes,
+                     (unsigned long long)stats.bus_time_us);
+            if (lvgl_driver_lock(lvgl_driver, -1)) {
+                esp_err_t err = esp_lcd_panel_virtual_dump_ppm(lcd_device->panel_handle, SD_MOUNT_POINT "/frame.ppm");
+                lvgl_driver_unlock(lvgl_driver);
+                ESP_LOGI(TAG, "Frame dump to " SD_MOUNT_POINT "/frame.ppm: %s", esp_err_to_name(err));
+            }
+#endif
+        } else if (strcmp(line, "pclk") == 0) {
+            ESP_LOGI(TAG, "Pixel clock: %d Hz", lcd_device->config.pixel_clock_hz);
+        } else if (strcmp(line, "pclk sweep") == 0) {
+            static const int clocks[] = ST7789_SWEEP_CLOCKS_HZ;
+            st7789_pclk_result_t results[sizeof(clocks) / sizeof(clocks[0])];
+            if (lvgl_driver_lock(lvgl_driver, -1)) {
+                esp_err_t err = st7789_pclk_sweep(lcd_device, clocks, sizeof(clocks) / sizeof(clocks[0]),
+                                                  ST7789_SWEEP_FRAMES, results);
+                lv_obj_invalidate(lv_scr_act());
+                lvgl_driver_unlock(lvgl_driver);
+                ESP_LOGI(TAG, "Pixel clock sweep: %s", esp_err_to_name(err));
+                if (!lcd_device->is_initialized) {
+                    ESP_LOGE(TAG, "LCD has no panel IO left, reboot to recover");
+                }
+            }
+        } else if (strncmp(line, "pclk ", 5) == 0) {
+            int hz = atoi(line + 5);
+            if (lvgl_driver_lock(lvgl_driver, -1)) {
+                esp_err_t err = st7789_set_pixel_clock(lcd_device, hz);
+                lv_obj_invalidate(lv_scr_act());
+                lvgl_driver_unlock(lvgl_driver);
+                ESP_LOGI(TAG, "Set pixel clock %d Hz: %s", hz, esp_err_to_name(err));
+                if (!lcd_device->is_initialized) {
+                    ESP_LOGE(TAG, "LCD has no panel IO left, reboot to recover");
+                }
+            }
+        } else if (strncmp(line, "depth ", 6) == 0) {
+            int bits = atoi(line + 6);
+            esp_err_t err = lvgl_driver_set_color_depth(lvgl_driver, (uint8_t)bits);
+            ESP_LOGI(TAG, "Set color depth %d bpp: %s", bits, esp_err_to_name(err));
+        } else {
+            ESP_LOGW(TAG, "Unknown command: %s", line);
+        }
+        len = 0;
+    }
+}
+#endif
+
 void app_main(void)
 {
     esp_err_t ret;
@@ -42,27 +166,19 @@ void app_main(void)
     ESP_LOGI(TAG, "ESP32-C6 LCD Demo - OOP Refactored");
     ESP_LOGI(TAG, "========================================");
 
-    // ========== Step 1: Initialize Wireless (WiFi/BLE) ==========
-    ESP_LOGI(TAG, "Step 1: Initializing wireless...");
-    Wireless_Init();
-    Flash_Searching();
-
-    // ========== Step 2: Initialize RGB LED ==========
-    ESP_LOGI(TAG, "Step 2: Initializing RGB LED...");
-    ret = RGB_Init();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize RGB LED: %s", esp_err_to_name(ret));
-    } else {
-        ESP_LOGI(TAG, "✓ RGB LED initialized");
-        RGB_Example();  // Start default rainbow effect
-    }
-
-    // ========== Step 3: Initialize SPI Bus ==========
-    ESP_LOGI(TAG, "Step 3: Initializing SPI bus...");
+    // ========== Step 1: Initialize SPI Bus ==========
+    ESP_LOGI(TAG, "Step 1: Initializing SPI bus...");
     spi_bus_init();
 
-    // ========== Step 4: Initialize LCD (New OOP API) ==========
-    ESP_LOGI(TAG, "Step 4: Initializing ST7789 LCD...");
+    // ========== Step 2: Start LCD initialization (New OOP API) ==========
+    // The panel spends most of its bring-up waiting for reset recovery and
+    // sleep-out, so by default it initializes in a background task while the
+    // other peripherals are set up below (CONFIG_LCD_INIT_IN_BACKGROUND).
+#if CONFIG_LCD_INIT_IN_BACKGROUND
+    ESP_LOGI(TAG, "Step 2: Initializing ST7789 LCD in the background...");
+#else
+    ESP_LOGI(TAG, "Step 2: Initializing ST7789 LCD...");
+#endif
 
     // Create LCD with default configuration
     st7789_config_t lcd_config = st7789_get_default_config();
@@ -73,20 +189,52 @@ void app_main(void)
         return;
     }
 
-    // Initialize LCD hardware
+#if CONFIG_LCD_INIT_IN_BACKGROUND
+    ret = st7789_init_async(lcd_device);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start LCD initialization: %s", esp_err_to_name(ret));
+        return;
+    }
+#else
     ret = st7789_init(lcd_device);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize LCD: %s", esp_err_to_name(ret));
         return;
     }
+#endif
 
-    // Set backlight
-    st7789_backlight_set(lcd_device, 100);
+    // ========== Step 3: Initialize Wireless (WiFi/BLE) ==========
+    ESP_LOGI(TAG, "Step 3: Initializing wireless...");
+    Wireless_Init();
+    Flash_Searching();
+
+    // ========== Step 4: Initialize RGB LED ==========
+    ESP_LOGI(TAG, "Step 4: Initializing RGB LED...");
+    ret = RGB_Init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize RGB LED: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "✓ RGB LED initialized");
+        RGB_Example();  // Start default rainbow effect
+    }
 
     // ========== Step 5: Initialize SD Card ==========
     ESP_LOGI(TAG, "Step 5: Initializing SD card...");
     SD_Init();
 
+    // Wait for the LCD; the time spent here is what the overlap did not hide
+    int64_t wait_start = esp_timer_get_time();
+    ret = st7789_wait_init(lcd_device, -1);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize LCD: %s", esp_err_to_name(ret));
+        return;
+    }
+    ESP_LOGI(TAG, "✓ LCD ready (panel bring-up %lld us, waited %lld us)",
+             (long long)lcd_device->init_time_us, (long long)(esp_timer_get_time() - wait_start));
+
+    // Set backlight
+    st7789_backlight_set(lcd_device, 100);
+
     // ========== Step 6: Initialize LVGL (New OOP API) ==========
     ESP_LOGI(TAG, "Step 6: Initializing LVGL driver...");
 
@@ -95,8 +243,12 @@ void app_main(void)
 
     // Optional: Customize configuration
     // lvgl_config.buf_lines = 40;                      // Larger buffer (default: 20)
+    // lvgl_config.calibrate_buffers = true;            // Measure and pick buf_lines at init
     // lvgl_config.buf_alloc = LVGL_BUF_ALLOC_SPIRAM;   // Use SPIRAM if available
     // lvgl_config.rotation = 90;                       // Landscape mode
+    // lvgl_config.merge_flush_cost_us = 0;             // Disable area merging
+    // lvgl_config.idle_timeout_ms = 0;                 // Keep the panel at 60 Hz on static screens
+    // lvgl_config.idle_partial_height = 40;            // Only light the top 40 rows while static
 
     // Create LVGL driver
     lvgl_driver = lvgl_driver_create(&lvgl_config);
@@ -114,8 +266,16 @@ void app_main(void)
     ESP_LOGI(TAG, "✓ LVGL driver initialized");
 
     // ========== Step 7: Load UI Example ==========
+    // The render task is already running, so build the UI under the lock
     ESP_LOGI(TAG, "Step 7: Loading LVGL UI...");
-    Lvgl_Example1();
+    if (lvgl_driver_lock(lvgl_driver, -1)) {
+        Lvgl_Example1();
+        lv_refr_now(NULL);      // Draw the first frame now to time it
+        lvgl_driver_unlock(lvgl_driver);
+    }
+    // esp_timer starts counting before app_main, so this is time since boot
+    ESP_LOGI(TAG, "Boot to first frame: %lld ms (LCD init " LCD_INIT_MODE ")",
+             (long long)(esp_timer_get_time() / 1000));
 
     // Alternative demos (uncomment to try):
     // lv_demo_widgets();
@@ -124,20 +284,24 @@ void app_main(void)
     // lv_demo_stress();
     // lv_demo_music();
 
+#if CONFIG_LCD_DRIVER_CONSOLE
+    xTaskCreate(console_task, "console", 4096, NULL, 1, NULL);
+#if CONFIG_LVGL_DRIVER_METRICS
+    ESP_LOGI(TAG, "Type \"metrics\" for flush pipeline metrics, \"pclk sweep\" to benchmark SPI clocks");
+#else
+    ESP_LOGI(TAG, "Type \"pclk sweep\" to benchmark SPI clocks");
+#endif
+#endif
+
     ESP_LOGI(TAG, "========================================");
-    ESP_LOGI(TAG, "Initialization complete! Entering main loop...");
+    ESP_LOGI(TAG, "Initialization complete! LVGL runs in its render task");
     ESP_LOGI(TAG, "========================================");
 
-    // ========== Main Loop ==========
-    while (1) {
-        // Call LVGL task handler
-        lvgl_driver_task_handler(lvgl_driver);
-
-        // Lower priority task delay (10ms recommended)
-        vTaskDelay(pdMS_TO_TICKS(10));
-    }
+    // Nothing left to do here: LVGL runs in the driver's render task and
+    // sleeps until its next timer is due. Other tasks use
+    // lvgl_driver_lock()/lvgl_driver_unlock() around LVGL calls.
 
-    // Cleanup (never reached in this example, but shown for completeness)
+    // Cleanup (not done in this example, but shown for completeness)
     // lvgl_driver_destroy(lvgl_driver);
     // st7789_destroy(lcd_device);
 }
\ No newline at end of file